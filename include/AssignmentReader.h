@@ -0,0 +1,56 @@
+#ifndef ASSIGNMENT_READER_H
+#define ASSIGNMENT_READER_H
+
+#include <istream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "LineReader.h"
+
+/**
+ * @brief Reader for externally supplied variable assignments
+ *
+ * Reads a CSV stream whose header names the variables and whose rows hold
+ * exactly one value per variable (0/1 or F/T, blanks around it allowed).
+ * Rows are returned in blocks packed column-wise, one bit per row and 64
+ * rows per word, ready for BatchEvaluator::evaluateColumns.
+ */
+class AssignmentReader {
+public:
+    /**
+     * @brief Constructs a reader and consumes the CSV header
+     * @param input The stream to read assignments from
+     * @throws std::runtime_error if the header is missing or malformed
+     */
+    explicit AssignmentReader(std::istream& input);
+
+    /**
+     * @brief Retrieves the variable names from the header
+     * @return const std::vector<std::string>& The variables in column order
+     */
+    const std::vector<std::string>& getVariables() const { return variables; }
+
+    /**
+     * @brief Reads the next block of rows into packed columns
+     * @param columns Resized to one packed column per variable
+     * @param maxRows Maximum number of rows to read, a multiple of 64
+     * @return size_t Number of rows read; 0 at end of input
+     * @throws std::runtime_error if a row has the wrong width or a field is not a single value
+     */
+    size_t readBlock(std::vector<std::vector<uint64_t>>& columns, size_t maxRows);
+
+private:
+    LineReader reader;
+    std::vector<std::string> variables;
+
+    /**
+     * @brief Retrieves the next non-empty line without its terminator
+     * @param begin Set to the first character of the line
+     * @param end Set one past the last character of the line
+     * @return bool False at end of input
+     */
+    bool nextLine(const char*& begin, const char*& end);
+};
+
+#endif // ASSIGNMENT_READER_H
@@ -0,0 +1,247 @@
+#ifndef BATCH_EVALUATOR_H
+#define BATCH_EVALUATOR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "Node.h"
+#include "Evaluator.h"
+
+/**
+ * @brief Evaluates many formulas over a common variable set in one pass
+ *
+ * All formulas are compiled into one shared DAG: structurally identical
+ * subformulas (same operator, same operand nodes) become a single node, no
+ * matter which formula they came from. The assignment space of the union of
+ * the variables is then enumerated once, block by block, and every DAG node
+ * is computed exactly once per block, so the work is proportional to the
+ * number of distinct nodes rather than the total size of the formulas.
+ * Constant operands are folded and double negations removed while the DAG
+ * is built.
+ *
+ * A DAG can also be built node by node, without any syntax tree, by starting
+ * from an empty BatchEvaluator and calling addVariable, addConstant,
+ * addOperation and addOutput (FormulaImporter does this for large files),
+ * then sortVariables once every formula has been added.
+ */
+class BatchEvaluator {
+public:
+    // Operation of a DAG node; operands always precede the nodes that use them
+    enum class Op : uint8_t {
+        FALSE_CONST, TRUE_CONST, VARIABLE, NOT, AND, OR, IMPLIES, EQUIVALENT
+    };
+
+    struct DagNode {
+        Op op;
+        uint8_t padding[3];
+        uint32_t left;      // Operand index, or variable index for VARIABLE
+        uint32_t right;     // Second operand index for binary operators
+    };
+
+    /**
+     * @brief Compiles the formulas into one shared DAG
+     * @param roots Parse trees of the formulas; they are not modified or owned
+     * @throws std::runtime_error if a tree contains an unknown operator
+     */
+    explicit BatchEvaluator(const std::vector<Node*>& roots);
+
+    /**
+     * @brief Creates an empty DAG to be built node by node
+     */
+    BatchEvaluator() = default;
+
+    /**
+     * @brief Adds a variable node, numbering the variable when it is first seen
+     * @param name Variable name
+     * @return uint32_t DAG index of the variable
+     */
+    uint32_t addVariable(const std::string& name);
+
+    /**
+     * @brief Adds a constant node
+     * @param value The constant
+     * @return uint32_t DAG index of the constant
+     */
+    uint32_t addConstant(bool value);
+
+    /**
+     * @brief Adds an operator node, folding constants and sharing identical nodes
+     * @param op NOT or a binary operator
+     * @param left DAG index of the (first) operand
+     * @param right DAG index of the second operand; ignored for NOT
+     * @return uint32_t DAG index of the (possibly simplified) node
+     */
+    uint32_t addOperation(Op op, uint32_t left, uint32_t right = 0);
+
+    /**
+     * @brief Marks a node as the result of the next formula; its label is left empty
+     * @param node DAG index of the formula
+     */
+    void addOutput(uint32_t node);
+
+    /**
+     * @brief Renumbers the variables in sorted order, as the truth tables expect
+     */
+    void sortVariables();
+
+    /**
+     * @brief Sets every empty formula label to the formula's string form, as Evaluator::nodeToString prints it
+     */
+    void labelOutputs();
+
+    /**
+     * @brief Rebuilds the syntax tree of a node, for modes that show subexpressions
+     * @param node DAG index of the subformula
+     * @return Node* Root of the new tree, owned by the caller
+     */
+    Node* toTree(uint32_t node) const;
+
+    /**
+     * @brief Enumerates the shared assignment space once
+     * @return Columns for the variables followed by one result column per formula
+     * @throws std::runtime_error if there are too many variables to enumerate
+     */
+    TruthColumns evaluate() const;
+
+    /**
+     * @brief Evaluates one formula over supplied assignments instead of enumerating them
+     * @param output Index of the formula
+     * @param inputs Packed column of each variable, in getVariables() order, 64 rows per word
+     * @param numRows Number of rows held in the columns
+     * @param scratch Working storage, reused between calls to avoid reallocating it
+     * @return Packed result column with unused tail bits cleared
+     */
+    std::vector<uint64_t> evaluateColumns(size_t output, const std::vector<const uint64_t*>& inputs,
+                                          size_t numRows, std::vector<uint64_t>& scratch) const;
+
+    /**
+     * @brief Evaluates one formula over part of the truth table
+     * @param output Index of the formula
+     * @param firstWord Index of the first 64-row word to evaluate
+     * @param numWords Number of 64-row words to evaluate
+     * @param scratch Working storage, reused between calls to avoid reallocating it
+     * @return The result words for rows [64 * firstWord, 64 * (firstWord + numWords)), unused tail bits cleared
+     * @throws std::runtime_error if there are too many variables to enumerate
+     */
+    std::vector<uint64_t> evaluateRange(size_t output, size_t firstWord, size_t numWords,
+                                        std::vector<uint64_t>& scratch) const;
+
+    /**
+     * @brief Retrieves the number of distinct DAG nodes
+     * @return size_t Node count after sharing
+     */
+    size_t distinctNodes() const { return nodes.size(); }
+
+    const std::vector<std::string>& getVariables() const { return variables; }
+    const std::vector<DagNode>& getNodes() const { return nodes; }
+    const std::vector<uint32_t>& getOutputs() const { return outputs; }
+    const std::vector<std::string>& getLabels() const { return labels; }
+
+    /**
+     * @brief Enumerates the assignment space of a DAG held in plain arrays
+     * @param nodes Topologically ordered DAG nodes
+     * @param nodeCount Number of DAG nodes
+     * @param outputs DAG node of each formula
+     * @param outputCount Number of formulas
+     * @param variableCount Number of variables
+     * @return Columns for the variables followed by one result column per formula, without labels
+     * @throws std::runtime_error if there are too many variables to enumerate
+     */
+    static TruthColumns evaluateDag(const DagNode* nodes, size_t nodeCount,
+                                    const uint32_t* outputs, size_t outputCount,
+                                    size_t variableCount);
+
+private:
+    /**
+     * @brief Evaluates a block of 64-row words for every DAG node
+     * @param nodes Topologically ordered DAG nodes
+     * @param nodeCount Number of DAG nodes
+     * @param inputs Packed column of each variable; nullptr enumerates the truth table rows
+     * @param first Index of the first word of the block
+     * @param count Number of words in the block, at most stride
+     * @param stride Words reserved per node in scratch
+     * @param scratch Receives the block of node i at scratch[i * stride]
+     */
+    static void evaluateBlock(const DagNode* nodes, size_t nodeCount, const uint64_t* const* inputs,
+                              size_t first, size_t count, size_t stride, uint64_t* scratch);
+
+    /**
+     * @brief Chooses the block size for a DAG so its scratch space stays bounded
+     * @param nodeCount Number of DAG nodes
+     * @return size_t Words per block, between 1 and 64
+     */
+    static size_t blockWords(size_t nodeCount);
+
+    std::vector<std::string> variables;     // Sorted union of all formula variables
+    std::vector<DagNode> nodes;             // Topologically ordered DAG
+    std::vector<uint32_t> outputs;          // DAG node of each formula
+    std::vector<std::string> labels;        // Display string of each formula
+
+    // Sharing state, used while the DAG is built
+    std::unordered_map<std::string, uint32_t> variableNumbers;  // Variable name -> variable index
+    std::vector<uint32_t> variableNodes;    // DAG index of each variable's node
+    uint32_t constantNodes[2] = {UINT32_MAX, UINT32_MAX};  // DAG index of FALSE and TRUE, once added
+    std::vector<uint32_t> firstParents;     // First node whose newer operand is each node, flagged once indexed
+    std::vector<uint64_t> slots;            // Open-addressing hash table of indexed operator nodes
+    size_t indexedNodes = 0;                // Entries in slots
+
+    /**
+     * @brief Adds a subtree to the DAG, reusing existing identical nodes
+     * @param node Current node in the syntax tree
+     * @return uint32_t DAG index of the subtree
+     */
+    uint32_t intern(Node* node);
+
+    /**
+     * @brief Adds an operator node after folding constants, reusing an identical node
+     * @param dagNode The node to add; its operands are already in the DAG
+     * @return uint32_t DAG index of the (possibly simplified) node
+     */
+    uint32_t addNode(DagNode dagNode);
+
+    /**
+     * @brief Appends a node without looking for an identical one
+     * @param dagNode The node to add; its operands are already in the DAG
+     * @return uint32_t DAG index of the new node
+     * @throws std::runtime_error if the DAG is full
+     */
+    uint32_t pushNode(const DagNode& dagNode);
+
+    /**
+     * @brief Adds a node to the sharing table
+     * @param node DAG index of the node
+     */
+    void indexNode(uint32_t node);
+
+    /**
+     * @brief Looks up an operator node in the sharing table
+     * @param dagNode The node to find
+     * @return uint32_t DAG index of the identical node, or UINT32_MAX if there is none
+     */
+    uint32_t findNode(const DagNode& dagNode) const;
+
+    /**
+     * @brief Rebuilds the sharing table with room for more nodes
+     * @param size Number of slots, a power of two above the number of indexed nodes
+     */
+    void rehash(size_t size);
+
+    /**
+     * @brief Appends the string form of a node, as Evaluator::nodeToString prints it
+     * @param node DAG index of the subformula
+     * @param out String to append to
+     */
+    void appendString(uint32_t node, std::string& out) const;
+
+    /**
+     * @brief Computes the sharing key of a node
+     * @param dagNode The node
+     * @return uint64_t Operator and operands packed into one word
+     */
+    static uint64_t nodeKey(const DagNode& dagNode) {
+        return (uint64_t(dagNode.op) << 56) | (uint64_t(dagNode.left) << 28) | dagNode.right;
+    }
+};
+
+#endif // BATCH_EVALUATOR_H
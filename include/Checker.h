@@ -0,0 +1,65 @@
+#ifndef CHECKER_H
+#define CHECKER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "BatchEvaluator.h"
+
+/**
+ * @brief Searches the truth table for a single row with a given result
+ *
+ * Answers validity (is there a false row?) and satisfiability (is there a
+ * true row?) without building the table. Worker threads claim blocks of
+ * 64-row words in increasing order and evaluate them on the formula's
+ * compiled DAG with BatchEvaluator::evaluateRange. Once a row is found, blocks after it are
+ * no longer claimed, so the search stops a few blocks past the first
+ * witness. Blocks before it still finish, so the reported row is always the
+ * lowest one, whatever the thread count.
+ */
+class Checker {
+public:
+    // 64-row words claimed by a worker at a time
+    static const size_t kBlockWords = 16;
+
+    /**
+     * @brief Constructs a checker for an expression
+     * @param root Root of the expression's syntax tree; it is only read while compiling
+     * @param threads Number of worker threads; 0 uses the hardware concurrency
+     */
+    explicit Checker(Node* root, size_t threads = 0);
+
+    /**
+     * @brief Constructs a checker for one formula of a compiled DAG
+     * @param dag The DAG, with its variables sorted
+     * @param output Index of the formula in the DAG
+     * @param threads Number of worker threads; 0 uses the hardware concurrency
+     */
+    Checker(BatchEvaluator dag, size_t output, size_t threads = 0);
+
+    /**
+     * @brief Finds the lowest truth table row where the expression has the given value
+     * @param value The result to look for: true for a witness, false for a counterexample
+     * @param row Set to the row index when one is found
+     * @return bool False if no row has that result
+     * @throws std::runtime_error if there are too many variables to enumerate
+     */
+    bool findRow(bool value, size_t& row);
+
+    const std::vector<std::string>& getVariables() const { return dag.getVariables(); }
+
+    /**
+     * @brief Retrieves the number of 64-row words evaluated by the last search
+     * @return size_t Words evaluated across all threads
+     */
+    size_t wordsSearched() const { return searched; }
+
+private:
+    BatchEvaluator dag;         // Variables are sorted; variable j is bit j of the row index
+    size_t output;
+    size_t threads;
+    size_t searched = 0;
+};
+
+#endif // CHECKER_H
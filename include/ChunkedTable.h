@@ -0,0 +1,65 @@
+#ifndef CHUNKED_TABLE_H
+#define CHUNKED_TABLE_H
+
+#include <ostream>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "Evaluator.h"
+
+/**
+ * @brief Writes a truth table to disk in fixed-size chunks of assignment space
+ *
+ * The table directory holds a text manifest and one binary file per chunk.
+ * Every chunk covers the same number of rows (a power of two) and stores,
+ * for each non-variable column in manifest order, its packed words (one bit
+ * per row, 64 rows per little-endian word). Variable columns are not stored:
+ * variable j is bit j of the row index.
+ *
+ * Because all chunks have the same size, concatenating the chunk files in
+ * index order yields a single table where the word for (chunk c, column k,
+ * word w) sits at offset ((c * columns + k) * words_per_chunk + w) * 8, so
+ * the merged file can be mmapped and indexed directly.
+ *
+ * Chunks are written to a temporary name and renamed when complete. A rerun
+ * with the same manifest skips chunks that already exist, so an interrupted
+ * run resumes from the first missing chunk.
+ */
+class ChunkedTableWriter {
+public:
+    /**
+     * @brief Constructs a writer for one table directory
+     * @param directory Directory receiving the manifest and chunk files
+     * @param maxMemory Budget in bytes for the columns of one chunk
+     */
+    ChunkedTableWriter(const std::string& directory, size_t maxMemory);
+
+    /**
+     * @brief Generates and writes every missing chunk of an expression's truth table
+     * @param evaluator Evaluator holding the parsed expression
+     * @param log Stream receiving a one-line summary
+     * @throws std::runtime_error if the budget is too small or a file cannot be written
+     */
+    void write(Evaluator& evaluator, std::ostream& log);
+
+private:
+    std::string directory;
+    size_t maxMemory;
+
+    /**
+     * @brief Builds the path of a chunk file
+     * @param chunk Index of the chunk
+     * @return std::string The chunk file path
+     */
+    std::string chunkPath(size_t chunk) const;
+};
+
+/**
+ * @brief Parses a memory size such as "512K", "256M" or "2G"
+ * @param text The size, in bytes unless suffixed with K, M or G
+ * @return size_t The size in bytes
+ * @throws std::runtime_error if the text is not a valid size
+ */
+size_t parseMemorySize(const std::string& text);
+
+#endif // CHUNKED_TABLE_H
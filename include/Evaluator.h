@@ -6,9 +6,31 @@
 #include <string>
 #include <set>
 #include <cmath>
+#include <cstdint>
 #include <utility>
 #include "Node.h"
 
+// Packed truth table: columns[i] holds one bit per row for labels[i], 64 rows per word
+struct TruthColumns {
+    std::vector<std::string> labels;
+    std::vector<std::vector<uint64_t>> columns;
+    size_t firstRow = 0;    // Row index of bit 0 of each column (non-zero for chunks)
+    size_t numRows = 0;
+
+    bool get(size_t column, size_t row) const {
+        return (columns[column][row / 64] >> (row % 64)) & 1;
+    }
+};
+
+// Subexpression columns kept between evaluations, keyed by Evaluator::structureKey.
+// Entries are only valid for the variable order they were computed with.
+struct ColumnCache {
+    std::vector<std::string> variables;
+    size_t firstWord = 0;   // First 64-row word the cached columns start at
+    std::unordered_map<std::string, std::vector<uint64_t>> columns;
+    size_t bytes = 0;       // Size of the cached columns and their keys
+};
+
 class Evaluator {
 public:
     // Constructor that takes the root of the parse tree
@@ -22,16 +44,65 @@ public:
     std::pair<std::vector<std::pair<std::unordered_map<std::string, bool>, std::unordered_map<std::string, bool>>>,
               std::vector<std::string>> generateTruthTable();
 
+    // Function to evaluate a logical expression for 64 assignments at once (one per bit)
+    uint64_t evaluateBits(Node* node, const std::unordered_map<std::string, uint64_t>& values);
+
+    // Function to generate the packed result column (bit i holds row i of the truth table)
+    std::vector<uint64_t> generateResultColumn(std::vector<std::string>& variables);
+
+    // Function to generate the result words for rows [64 * firstWord, 64 * (firstWord + numWords))
+    std::vector<uint64_t> generateResultRange(size_t firstWord, size_t numWords);
+
+    // Function to generate the truth table as packed columns, reusing and filling an optional cache
+    TruthColumns generateTruthColumns(ColumnCache* cache = nullptr);
+
+    // Function to generate the truth table rows [64 * firstWord, 64 * (firstWord + numWords)) as packed columns
+    TruthColumns generateTruthChunk(size_t firstWord, size_t numWords);
+
+    // Function to generate only the requested columns (plus the variables) without tracking the rest
+    TruthColumns generateSelectedColumns(const std::vector<std::string>& selected);
+
+    // Function to count the packed columns held while generating the truth table
+    size_t countColumns();
+
+    // Function to collect the sorted table variables, rejecting tables too wide to enumerate
+    std::vector<std::string> tableVariables();
+
+    // Function to list the truth table columns in display order
+    std::vector<std::string> columnLabels(const std::vector<std::string>& variables);
+
     // Add this new method declaration to the Evaluator class
     std::set<std::string> collectVariables(Node* node);
 
     // Add this function declaration in the header file
     void print_tree(Node* node, int level = 0);
 
-private:
-    // Helper function to convert a node to its string representation
+    // Function to convert a node to its string representation (the label of its truth table column)
     std::string nodeToString(Node* node);
 
+    // Function to build a string identifying a subtree by its shape; distinct shapes never share one
+    std::string structureKey(Node* node);
+
+private:
+    // Helper function to find the subtree whose string form matches a column label
+    Node* findSubExpression(Node* node, const std::string& label);
+
+    // Helper function to add the variables of a subtree to a set
+    void collectVariables(Node* node, std::set<std::string>& variables);
+
+    // Helper function to collect the string form of every subexpression
+    void collectSubExpressions(Node* node, std::set<std::string>& expressions);
+
+    // Helper function to collect the structural key of every subexpression
+    void collectStructures(Node* node, std::set<std::string>& structures);
+
+    // Helper function to map each column label to the subtree it shows
+    void collectLabelNodes(Node* node, std::unordered_map<std::string, Node*>& labelNodes);
+
+    // Helper function to compute (or fetch from the cache) the packed column of a subtree
+    const std::vector<uint64_t>& buildColumn(Node* node, size_t numWords, size_t totalRows,
+                                             ColumnCache& cache);
+
     // Root node of the parse tree
     Node* root;
 };
@@ -39,4 +110,10 @@ private:
 // Add this declaration before the closing bracket of the header file
 void print_tree(Node* node, int level = 0);
 
+// Returns the 64-row word of variable j's column for rows [64 * word, 64 * word + 63]
+uint64_t variableWord(size_t j, size_t word);
+
+// Returns the mask of valid rows in a word of a column with the given number of rows
+uint64_t rowMask(size_t numRows, size_t word);
+
 #endif // EVALUATOR_H
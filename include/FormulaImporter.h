@@ -0,0 +1,150 @@
+#ifndef FORMULA_IMPORTER_H
+#define FORMULA_IMPORTER_H
+
+#include <istream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "BatchEvaluator.h"
+#include "LineReader.h"
+
+/**
+ * @brief Streaming reader for large formula files
+ *
+ * Reads DIMACS CNF or multi-line infix formulas in fixed-size chunks and
+ * adds them straight to a BatchEvaluator DAG from the buffered bytes, with
+ * no syntax tree, token vector or string per token. The DAG shares
+ * identical subformulas, folds constants and removes double negations as
+ * the formulas are read. The format is detected from the first
+ * non-blank character: DIMACS files start with a lowercase `c` comment or
+ * `p cnf` header, and infix files never do.
+ *
+ * DIMACS variable k becomes variable `Xk`, with k zero-padded to the width
+ * of the declared variable count so the columns sort numerically. The
+ * clauses are combined into a balanced AND of balanced ORs, and each
+ * literal's node is built once and reused by every clause that mentions
+ * it. Infix files hold one or more formulas in the scanner's keyword syntax, each ending at `;` or at the end of the
+ * file; line breaks are ordinary whitespace and `#` starts a comment.
+ * Variables are an uppercase letter optionally followed by digits (`P`,
+ * `X12`). Runs of the same AND, OR or EQUIVALENT operator are balanced, so
+ * formulas stay shallow however long they are.
+ */
+class FormulaImporter {
+public:
+    enum class Format { DIMACS, INFIX };
+
+    /**
+     * @brief Constructs an importer and detects the file format
+     * @param input The stream to read formulas from
+     */
+    explicit FormulaImporter(std::istream& input);
+
+    Format getFormat() const { return format; }
+
+    /**
+     * @brief Reads the next formula into a DAG
+     * @param target The DAG receiving the formula as its next output; call
+     *        BatchEvaluator::sortVariables before evaluating it
+     * @return bool False at end of input
+     * @throws std::runtime_error with the line number if the input is malformed
+     */
+    bool next(BatchEvaluator& target);
+
+    // Counts from the DIMACS header, and clauses actually read
+    size_t getDeclaredVariables() const { return declaredVariables; }
+    size_t getDeclaredClauses() const { return declaredClauses; }
+    size_t getClauseCount() const { return clauses; }
+
+private:
+    enum class TokenKind {
+        END, SEMICOLON, LEFT_PAREN, RIGHT_PAREN, VARIABLE, TRUE, FALSE,
+        NOT, AND, OR, IMPLIES, EQUIVALENT
+    };
+
+    LineReader reader;
+    const char* cursor;         // Next unparsed character of the current line
+    const char* lineEnd;        // One past the last character of the current line
+    Format format;
+    bool finished;
+
+    size_t declaredVariables;
+    size_t declaredClauses;
+    size_t clauses;
+
+    TokenKind lookahead;        // Current infix token
+    std::string lexeme;         // Text of the current token, reused across tokens
+
+    BatchEvaluator* dag;                // DAG receiving the formula being read
+    std::vector<uint32_t> literalNodes; // DAG node of DIMACS literal 2k (Xk) and 2k+1 (NOT Xk)
+
+    /**
+     * @brief Skips blanks and comments up to the next character to parse
+     * @param comment Character that starts a comment running to the end of the line
+     * @return bool False at end of input
+     */
+    bool skipBlank(char comment);
+
+    /**
+     * @brief Reads a whole DIMACS CNF file
+     * @return uint32_t DAG index of the balanced conjunction of the clauses
+     */
+    uint32_t readDimacs();
+
+    /**
+     * @brief Names a DIMACS variable, zero-padded so names sort in numeric order
+     * @param variable The variable number, at most the declared count
+     * @return std::string The name, e.g. X07 when up to 99 variables are declared
+     */
+    std::string dimacsName(size_t variable) const;
+
+    /**
+     * @brief Finds or adds the DAG node of a DIMACS literal
+     * @param variable The variable number, at least 1
+     * @param negative True for the negated literal
+     * @return uint32_t DAG index of the literal
+     */
+    uint32_t dimacsLiteral(size_t variable, bool negative);
+
+    /**
+     * @brief Reads the DIMACS "p cnf <variables> <clauses>" header from the current line
+     */
+    void readHeader();
+
+    /**
+     * @brief Reads the next infix token into lookahead and lexeme
+     */
+    void advance();
+
+    /**
+     * @brief Parses a sequence of terms joined by binary operators
+     * @return uint32_t DAG index of the parsed subformula
+     */
+    uint32_t parseSentence();
+
+    /**
+     * @brief Parses a variable, constant, negation or parenthesized sentence
+     * @return uint32_t DAG index of the parsed subformula
+     */
+    uint32_t parseTerm();
+
+    /**
+     * @brief Builds an error for the current line
+     * @param message Description of the problem
+     * @return std::runtime_error The error to throw
+     */
+    std::runtime_error error(const std::string& message) const;
+
+    /**
+     * @brief Joins operands with one operator as a balanced tree
+     * @param op The binary operator
+     * @param operands DAG indices of the operands
+     * @param first Index of the first operand to join
+     * @param count Number of operands to join, at least one
+     * @return uint32_t DAG index of the balanced tree
+     */
+    uint32_t combine(BatchEvaluator::Op op, const std::vector<uint32_t>& operands,
+                     size_t first, size_t count);
+};
+
+#endif // FORMULA_IMPORTER_H
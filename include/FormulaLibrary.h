@@ -0,0 +1,91 @@
+#ifndef FORMULA_LIBRARY_H
+#define FORMULA_LIBRARY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "BatchEvaluator.h"
+
+/**
+ * @brief Precompiled binary library of formulas
+ *
+ * A library file holds the shared DAG of a BatchEvaluator so later runs can
+ * skip scanning and parsing. Everything is stored little-endian at its
+ * natural alignment, in this order:
+ *
+ *     Header                                  (32 bytes)
+ *     DagNode  nodes[nodeCount]               (12 bytes each, topological order)
+ *     uint32_t outputs[formulaCount]          (DAG node of each formula)
+ *     padding to a multiple of 8 bytes
+ *     uint64_t stringOffsets[variableCount + formulaCount + 1]
+ *     char     strings[stringBytes]           (variable names, then column labels)
+ *
+ * Loading reads the file with a single read into an 8-byte aligned buffer,
+ * checks that every offset and index is in range, and then evaluates the
+ * node arrays where they lie; no per-node or per-formula objects are built.
+ */
+class FormulaLibrary {
+public:
+    static const uint32_t kVersion = 1;
+
+    /**
+     * @brief Writes the compiled DAG of a batch to a library file
+     * @param batch The compiled formulas
+     * @param path Path of the library file to create
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void write(const BatchEvaluator& batch, const std::string& path);
+
+    /**
+     * @brief Loads a library file for in-place evaluation
+     * @param path Path of the library file
+     * @throws std::runtime_error if the file is missing, from another version or corrupt
+     */
+    explicit FormulaLibrary(const std::string& path);
+
+    size_t formulaCount() const { return header().formulaCount; }
+    size_t nodeCount() const { return header().nodeCount; }
+
+    /**
+     * @brief Evaluates every formula of the library in one pass
+     * @return Columns for the variables followed by one result column per formula
+     */
+    TruthColumns evaluate() const;
+
+private:
+    struct Header {
+        char magic[8];              // "LOGICLIB"
+        uint32_t version;           // kVersion
+        uint32_t byteOrder;         // 0x01020304 as written by the compiling machine
+        uint32_t variableCount;
+        uint32_t nodeCount;
+        uint32_t formulaCount;
+        uint32_t stringBytes;
+    };
+
+    std::vector<uint64_t> buffer;   // File contents; uint64_t keeps every array aligned
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(buffer.data()); }
+    const BatchEvaluator::DagNode* nodes() const;
+    const uint32_t* outputs() const;
+    const uint64_t* stringOffsets() const;
+    const char* strings() const;
+
+    /**
+     * @brief Computes the byte offset of the string offset table
+     * @param nodeCount Number of DAG nodes
+     * @param formulaCount Number of formulas
+     * @return size_t Offset from the start of the file
+     */
+    static size_t offsetsPosition(size_t nodeCount, size_t formulaCount);
+
+    /**
+     * @brief Retrieves one string of the string table
+     * @param index Variables first, then formula labels
+     * @return std::string A copy of the string
+     */
+    std::string stringAt(size_t index) const;
+};
+
+#endif // FORMULA_LIBRARY_H
@@ -0,0 +1,44 @@
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <istream>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Chunked line reader for large input streams
+ *
+ * Reads the stream in fixed-size chunks and hands out each line as a pair
+ * of pointers into the buffer, so no string is built per line. A line stays
+ * valid until the next call to next().
+ */
+class LineReader {
+public:
+    /**
+     * @brief Constructs a reader for a stream
+     * @param input The stream to read lines from
+     */
+    explicit LineReader(std::istream& input);
+
+    /**
+     * @brief Retrieves the next line without its newline
+     * @param begin Set to the first character of the line
+     * @param end Set one past the last character of the line
+     * @return bool False at end of input
+     */
+    bool next(const char*& begin, const char*& end);
+
+    /**
+     * @brief Retrieves the number of the line returned last, counting from 1
+     * @return size_t The line number; 0 before the first line
+     */
+    size_t getLine() const { return line; }
+
+private:
+    std::istream& input;
+    std::vector<char> buffer;   // Raw bytes read from the stream but not yet returned
+    size_t position;            // Start of the next unread line in buffer
+    size_t line;                // Number of lines returned so far
+};
+
+#endif // LINE_READER_H
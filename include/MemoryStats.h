@@ -0,0 +1,89 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Heap and resident-memory accounting
+ *
+ * When the program is built with -DLOGIC_MEM_STATS, MemoryStats.cpp replaces
+ * the global operator new and delete, including the over-aligned forms,
+ * with versions that count every allocation, the bytes requested, the bytes
+ * currently live and the peak of live bytes. Without the option the
+ * allocator is untouched, memoryCountingEnabled() is false and the counters
+ * stay zero. Peak resident set size comes from the operating system and is
+ * available either way where the platform reports it. It is the process's
+ * high-water mark since start-up, so it cannot be split into stages.
+ */
+
+// Snapshot of the allocation counters
+struct MemoryCounters {
+    uint64_t allocations = 0;   // Calls to operator new since start-up
+    uint64_t bytes = 0;         // Bytes requested by those calls
+    uint64_t liveBytes = 0;     // Bytes allocated and not yet freed
+    uint64_t peakBytes = 0;     // Highest liveBytes since start-up or the last resetMemoryPeak()
+};
+
+// Memory used by one stage of processing a formula
+struct StageUsage {
+    std::string stage;
+    uint64_t allocations = 0;   // Allocations made during the stage
+    uint64_t bytes = 0;         // Bytes requested during the stage
+    uint64_t peakBytes = 0;     // Highest live heap bytes while the stage ran
+};
+
+/**
+ * @brief Reports whether allocations are being counted
+ * @return bool True if built with LOGIC_MEM_STATS
+ */
+bool memoryCountingEnabled();
+
+/**
+ * @brief Reads the allocation counters
+ * @return MemoryCounters The current values
+ */
+MemoryCounters memoryCounters();
+
+/**
+ * @brief Restarts peak tracking from the current live byte count
+ */
+void resetMemoryPeak();
+
+/**
+ * @brief Retrieves the peak resident set size of the process since start-up
+ * @return uint64_t Bytes, or 0 where the platform does not report it
+ */
+uint64_t peakResidentBytes();
+
+/**
+ * @brief Attributes allocations to consecutive named stages
+ *
+ * start() closes the running stage, if any, and opens the next one; stop()
+ * closes the running stage. Stages with the same name, such as the parse of
+ * a formula and of its --columns, are accumulated into one entry.
+ */
+class MemoryMeter {
+public:
+    /**
+     * @brief Starts measuring a stage, ending the previous one
+     * @param stage Name of the stage
+     */
+    void start(const std::string& stage);
+
+    /**
+     * @brief Ends the running stage
+     */
+    void stop();
+
+    const std::vector<StageUsage>& getStages() const { return stages; }
+
+private:
+    std::vector<StageUsage> stages;
+    bool running = false;
+    size_t current = 0;         // Index in stages of the running stage
+    MemoryCounters begin;       // Counters when the running stage started
+};
+
+#endif // MEMORY_STATS_H
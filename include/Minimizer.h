@@ -0,0 +1,151 @@
+#ifndef MINIMIZER_H
+#define MINIMIZER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief Two-level minimizer for a truth table result column
+ *
+ * Derives a minimal sum-of-products and product-of-sums from the packed
+ * result column produced by Evaluator::generateResultColumn. Up to
+ * kMaxExactVariables, prime implicants are found with Quine-McCluskey on
+ * packed value/mask pairs and the cover is chosen from the essential primes
+ * plus a Petrick-style branch and bound seeded with a greedy cover.
+ *
+ * Wider functions, and functions with more than kMaxPrimes primes or a
+ * larger chart than kMaxChartEntries, use an Espresso-style heuristic
+ * instead: each uncovered row is expanded into the largest cube it can grow
+ * to without leaving the function, checked directly against the truth table,
+ * and cubes made redundant by later ones are dropped. The result is then
+ * only near-minimal, as it is when the branch and bound runs out of budget;
+ * the exact flag of minimalSOP and minimalPOS reports which one was found.
+ *
+ * Each cover starts one pool of worker threads. It splits the implicants of
+ * large Quine-McCluskey merge passes and the candidate variables of large
+ * heuristic cubes between the threads; the cover selection is sequential.
+ */
+class Minimizer {
+public:
+    static const size_t kMaxExactVariables = 16;
+    static const size_t kMaxVariables = 24;
+
+    // Limits on the exact method beyond which the heuristic is used
+    static const size_t kMaxPrimes = 50000;
+    static const size_t kMaxChartEntries = size_t(1) << 22;
+
+    /**
+     * @brief Constructs a minimizer for a packed result column
+     * @param variables Variable names; variable j is bit j of the row index
+     * @param column One bit per row, 64 rows per word
+     * @throws std::runtime_error if there are more than kMaxVariables variables
+     */
+    Minimizer(const std::vector<std::string>& variables, const std::vector<uint64_t>& column);
+
+    /**
+     * @brief Computes a minimal sum-of-products form
+     * @param exact Set to false when the result is only near-minimal
+     * @return std::string The expression in the evaluator's input syntax
+     */
+    std::string minimalSOP(bool& exact) const;
+
+    /**
+     * @brief Computes a minimal product-of-sums form
+     * @param exact Set to false when the result is only near-minimal
+     * @return std::string The expression in the evaluator's input syntax
+     */
+    std::string minimalPOS(bool& exact) const;
+
+private:
+    // A product term: bits set in mask are eliminated, the rest must equal value
+    struct Implicant {
+        uint32_t value;
+        uint32_t mask;
+    };
+
+    class WorkerPool;
+
+    std::vector<std::string> variables;
+    std::vector<uint64_t> column;
+
+    /**
+     * @brief Collects the rows whose result equals the requested value
+     * @param value True for minterms, false for maxterms
+     * @return std::vector<uint32_t> The matching row indices
+     */
+    std::vector<uint32_t> collectRows(bool value) const;
+
+    /**
+     * @brief Checks whether a row's result equals the requested value
+     * @param row The row index
+     * @param value True for minterms, false for maxterms
+     * @return bool True if the row belongs to the function being covered
+     */
+    bool rowMatches(uint32_t row, bool value) const {
+        return (((column[row / 64] >> (row % 64)) & 1) != 0) == value;
+    }
+
+    /**
+     * @brief Finds a small cover of the rows with the requested value
+     * @param rows The matching row indices, in ascending order
+     * @param value True for minterms, false for maxterms
+     * @param exact Set to false when the cover is only near-minimal
+     * @return std::vector<Implicant> The chosen cover, sorted for printing
+     */
+    std::vector<Implicant> findCover(const std::vector<uint32_t>& rows, bool value, bool& exact) const;
+
+    /**
+     * @brief Finds all prime implicants covering the given rows
+     * @param rows The row indices that must be covered, in ascending order
+     * @param primes Receives the prime implicants
+     * @param pool Workers sharing the merge passes
+     * @return bool False if more than kMaxPrimes implicants would be needed
+     */
+    bool primeImplicants(const std::vector<uint32_t>& rows, std::vector<Implicant>& primes,
+                         WorkerPool& pool) const;
+
+    /**
+     * @brief Selects a minimum set of prime implicants covering every row
+     * @param primes The candidate prime implicants
+     * @param rows The row indices that must be covered
+     * @param exact Set to false if the search budget ran out
+     * @return std::vector<Implicant> The chosen cover
+     */
+    std::vector<Implicant> selectCover(const std::vector<Implicant>& primes,
+                                       const std::vector<uint32_t>& rows, bool& exact) const;
+
+    /**
+     * @brief Builds a near-minimal cover by expanding rows into large cubes
+     * @param value True for minterms, false for maxterms
+     * @param pool Workers sharing the checks of large cubes
+     * @return std::vector<Implicant> An irredundant cover of the matching rows
+     */
+    std::vector<Implicant> expandCover(bool value, WorkerPool& pool) const;
+
+    /**
+     * @brief Formats a cover as a sum of products or a product of sums
+     * @param cover The implicants to format
+     * @param asClauses True to emit the product-of-sums form
+     * @return std::string The expression in the evaluator's input syntax
+     */
+    std::string formatCover(const std::vector<Implicant>& cover, bool asClauses) const;
+
+    /**
+     * @brief Counts the literals of an implicant
+     * @param implicant The implicant to measure
+     * @return size_t Number of variables not eliminated by the mask
+     */
+    size_t literalCount(const Implicant& implicant) const;
+
+    /**
+     * @brief Formats an implicant as a conjunction or a disjunction of literals
+     * @param implicant The implicant to format
+     * @param asClause True to emit the negated clause used by product-of-sums
+     * @return std::string The formatted term
+     */
+    std::string formatTerm(const Implicant& implicant, bool asClause) const;
+};
+
+#endif // MINIMIZER_H
@@ -0,0 +1,89 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+/**
+ * @brief Buffered output handed to a dedicated writer thread
+ *
+ * The producer appends text to the current block; full blocks are queued
+ * and written to the file by a background thread with one large fwrite
+ * each, so formatting the next block overlaps with writing the previous
+ * one. At most maxPending blocks may be queued: when the file is slower
+ * than the producer, write() waits for a free slot instead of letting the
+ * queue grow without bound.
+ */
+class OutputWriter {
+public:
+    static const size_t kDefaultBlockSize = 1 << 20;
+    static const size_t kDefaultMaxPending = 4;
+
+    /**
+     * @brief Starts the writer thread
+     * @param file Destination stream; it must stay open while the writer exists
+     * @param blockSize Bytes collected before a block is handed to the writer thread
+     * @param maxPending Maximum number of full blocks waiting to be written
+     */
+    explicit OutputWriter(std::FILE* file, size_t blockSize = kDefaultBlockSize,
+                          size_t maxPending = kDefaultMaxPending);
+
+    /**
+     * @brief Writes all remaining output and stops the writer thread
+     */
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /**
+     * @brief Appends bytes to the output
+     * @param data The bytes to append
+     * @param size Number of bytes
+     * @throws std::runtime_error if an earlier write to the file failed
+     */
+    void write(const char* data, size_t size);
+
+    void write(const std::string& text) { write(text.data(), text.size()); }
+
+    /**
+     * @brief Waits until everything appended so far has reached the file
+     * @throws std::runtime_error if a write to the file failed
+     */
+    void flush();
+
+private:
+    std::FILE* file;
+    size_t blockSize;
+    size_t maxPending;
+
+    std::string current;                // Block being filled by the producer
+    std::deque<std::string> pending;    // Full blocks waiting for the writer thread
+    std::vector<std::string> spare;     // Written blocks kept for reuse
+    bool writing;                       // The writer thread holds a block outside the queue
+    bool stopping;
+    bool failed;
+
+    std::mutex mutex;
+    std::condition_variable ready;      // Signalled when a block is queued or on stop
+    std::condition_variable drained;    // Signalled when a block has been written
+    std::thread thread;
+
+    /**
+     * @brief Queues the current block, waiting while the queue is full
+     */
+    void submit();
+
+    /**
+     * @brief Writer thread body: writes queued blocks until stopped
+     */
+    void run();
+};
+
+#endif // OUTPUT_WRITER_H
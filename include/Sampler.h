@@ -0,0 +1,72 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "BatchEvaluator.h"
+
+// Outcome of a sampling run: satisfying fraction with a Wilson score interval
+struct SampleResult {
+    size_t samples = 0;
+    size_t trueCount = 0;
+    double low = 0;         // Lower bound of the confidence interval
+    double high = 0;        // Upper bound of the confidence interval
+    bool foundSatisfying = false;
+    bool foundFalsifying = false;
+    std::vector<bool> satisfyingRow;    // First sampled satisfying assignment, by variable
+    std::vector<bool> falsifyingRow;    // First sampled falsifying assignment, by variable
+};
+
+/**
+ * @brief Monte Carlo estimate of how often a formula is true
+ *
+ * Draws uniformly random assignments and evaluates them 64 at a time on the
+ * formula's compiled DAG (BatchEvaluator::evaluateColumns): each random
+ * 64-bit word supplies one variable's value for 64 assignments. Only one block of random columns is held at a
+ * time, so time is proportional to the sample count and memory to the number
+ * of variables, however many variables the formula has.
+ */
+class Sampler {
+public:
+    // z value of the reported two-sided 95% confidence interval
+    static constexpr double kConfidenceZ = 1.959963984540054;
+
+    /**
+     * @brief Constructs a sampler for an expression
+     * @param root Root of the expression's syntax tree; it is only read while compiling
+     * @param seed Seed of the random generator; equal seeds give equal results
+     */
+    Sampler(Node* root, uint64_t seed);
+
+    /**
+     * @brief Constructs a sampler for one formula of a compiled DAG
+     * @param dag The DAG; examples list the variables in its order
+     * @param output Index of the formula in the DAG
+     * @param seed Seed of the random generator; equal seeds give equal results
+     */
+    Sampler(BatchEvaluator dag, size_t output, uint64_t seed);
+
+    /**
+     * @brief Evaluates the expression on random assignments
+     * @param samples Number of assignments to draw
+     * @return SampleResult Counts, confidence interval and example rows
+     */
+    SampleResult run(size_t samples);
+
+    const std::vector<std::string>& getVariables() const { return compiled.getVariables(); }
+
+private:
+    BatchEvaluator compiled;    // Compiled once; random columns follow its variable order
+    size_t output;              // Formula of compiled being sampled
+    uint64_t state[4];      // xoshiro256** state
+
+    /**
+     * @brief Fills a buffer with random words
+     * @param words Destination buffer
+     * @param count Number of words to generate
+     */
+    void fill(uint64_t* words, size_t count);
+};
+
+#endif // SAMPLER_H
@@ -0,0 +1,83 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "BatchEvaluator.h"
+
+/**
+ * @brief One worker's slice of a formula's result column
+ *
+ * The 2^n rows of a truth table are split into `count` contiguous ranges of
+ * 64-row words; shard `index` covers one of them. A shard file holds one
+ * section per formula, each a short text header followed by the packed
+ * result words, so shards can be produced on different machines and merged
+ * without any other context. Sections are matched up by the formula's
+ * position in the input, so a formula that occurs twice is merged twice:
+ *
+ *     LOGIC-SHARD 2
+ *     position: 0
+ *     formula: P AND Q
+ *     variables: P Q
+ *     rows: 4
+ *     shard: 0/2
+ *     first_word: 0
+ *     words: 1
+ *     true_count: 1
+ *     data:
+ *     <words * 8 bytes, little-endian whatever the host byte order>
+ */
+struct ShardSection {
+    size_t position = 0;        // Position of the formula in the input, from 0
+    std::string formula;
+    std::vector<std::string> variables;
+    size_t rows = 0;            // Rows in the full table
+    size_t index = 0;           // Shard number, from 0 to count - 1
+    size_t count = 1;           // Number of shards the table was split into
+    size_t firstWord = 0;       // First 64-row word covered by this shard
+    size_t numWords = 0;        // Number of words covered by this shard
+    size_t trueCount = 0;       // Rows of this shard where the formula is true
+    std::vector<uint64_t> words;
+};
+
+/**
+ * @brief Evaluates one shard of a formula's result column
+ * @param dag Compiled DAG holding the formula, with its variables sorted and its outputs labelled
+ * @param output Index of the formula in the DAG
+ * @param position Position of the formula in the input, from 0
+ * @param index Shard number, from 0 to count - 1
+ * @param count Number of shards
+ * @return ShardSection The evaluated slice
+ */
+ShardSection computeShard(const BatchEvaluator& dag, size_t output, size_t position,
+                          size_t index, size_t count);
+
+/**
+ * @brief Writes a shard section in the self-describing shard format
+ * @param out Binary output stream
+ * @param section The section to write
+ */
+void writeShard(std::ostream& out, const ShardSection& section);
+
+/**
+ * @brief Reads every section of a shard file
+ * @param path Path of the shard file
+ * @param withData False to skip the packed words when only counts are needed
+ * @return std::vector<ShardSection> The sections in file order
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+std::vector<ShardSection> readShards(const std::string& path, bool withData);
+
+/**
+ * @brief Combines shard sections into one section per formula
+ * @param sections Sections from any number of shard files, in any order
+ * @return std::vector<ShardSection> One full-table section per formula, in input order
+ * @throws std::runtime_error if a formula's shards overlap, disagree or leave gaps
+ */
+std::vector<ShardSection> mergeShards(const std::vector<ShardSection>& sections);
+
+#endif // SHARD_H
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include "../include/AssignmentReader.h"
+
+/**
+ * @brief Constructs a reader and consumes the CSV header
+ * @param input The stream to read assignments from
+ * @throws std::runtime_error if the header is missing or malformed
+ */
+AssignmentReader::AssignmentReader(std::istream& input) : reader(input) {
+    const char* begin;
+    const char* end;
+    if (!nextLine(begin, end)) {
+        throw std::runtime_error("Assignment input is empty; expected a header of variable names");
+    }
+
+    std::string name;
+    for (const char* c = begin; c <= end; ++c) {
+        if (c == end || *c == ',') {
+            if (name.empty()) {
+                throw std::runtime_error("Empty variable name in assignment header");
+            }
+            if (std::find(variables.begin(), variables.end(), name) != variables.end()) {
+                throw std::runtime_error("Duplicate variable in assignment header: " + name);
+            }
+            variables.push_back(name);
+            name.clear();
+        } else if (*c != ' ' && *c != '\t') {
+            name += *c;
+        }
+    }
+}
+
+/**
+ * @brief Retrieves the next non-empty line without its terminator
+ * @param begin Set to the first character of the line
+ * @param end Set one past the last character of the line
+ * @return bool False at end of input
+ */
+bool AssignmentReader::nextLine(const char*& begin, const char*& end) {
+    while (reader.next(begin, end)) {
+        if (end > begin && end[-1] == '\r') --end;
+        if (end > begin) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Reads the next block of rows into packed columns
+ * @param columns Resized to one packed column per variable
+ * @param maxRows Maximum number of rows to read, a multiple of 64
+ * @return size_t Number of rows read; 0 at end of input
+ * @throws std::runtime_error if a row has the wrong width or a field is not a single value
+ */
+size_t AssignmentReader::readBlock(std::vector<std::vector<uint64_t>>& columns, size_t maxRows) {
+    columns.resize(variables.size());
+    for (auto& column : columns) {
+        column.assign(maxRows / 64, 0);
+    }
+
+    size_t rows = 0;
+    const char* begin;
+    const char* end;
+    while (rows < maxRows && nextLine(begin, end)) {
+        size_t field = 0;
+        size_t values = 0;      // Value characters seen in the current field
+        uint64_t bit = uint64_t(1) << (rows % 64);
+        for (const char* c = begin; c <= end; ++c) {
+            if (c == end || *c == ',') {
+                if (values != 1) {
+                    throw std::runtime_error("Assignment line " + std::to_string(reader.getLine()) +
+                                             " has " + (values ? "more than one value" : "an empty value") +
+                                             " in column " + std::to_string(field + 1));
+                }
+                if (c < end) ++field;
+                values = 0;
+                continue;
+            }
+
+            switch (*c) {
+                case ' ': case '\t':
+                    break;
+                case '1': case 'T': case 't':
+                    if (field < columns.size()) columns[field][rows / 64] |= bit;
+                    ++values;
+                    break;
+                case '0': case 'F': case 'f':
+                    ++values;
+                    break;
+                default:
+                    throw std::runtime_error("Invalid value '" + std::string(1, *c) +
+                                             "' in assignment line " + std::to_string(reader.getLine()));
+            }
+        }
+
+        if (field + 1 != variables.size()) {
+            throw std::runtime_error("Assignment line " + std::to_string(reader.getLine()) + " has " +
+                                     std::to_string(field + 1) + " values, expected " +
+                                     std::to_string(variables.size()));
+        }
+        ++rows;
+    }
+
+    return rows;
+}
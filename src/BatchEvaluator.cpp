@@ -0,0 +1,576 @@
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include "../include/BatchEvaluator.h"
+
+// Most 64-row words evaluated per block; keeps the scratch rows of small DAGs cache-resident
+static const size_t kMaxBlockWords = 64;
+
+// Scratch words per block for large DAGs, which get shorter blocks instead of more memory
+static const size_t kScratchWords = size_t(1) << 22;
+
+// Node indices are packed into 28 bits of the sharing key
+static const uint32_t kMaxDagNodes = uint32_t(1) << 28;
+
+// A slot of the sharing table holds the node's index + 1 in its low bits and the
+// top bits of the node's hash above them, so most probes never read the node;
+// 0 marks an empty slot
+static const int kSlotIndexBits = 29;
+static const uint64_t kSlotIndexMask = (uint64_t(1) << kSlotIndexBits) - 1;
+
+// Slots in a new sharing table
+static const size_t kMinSlots = 1024;
+
+// Marks a missing node, such as a variable without a node or a node nothing is built on
+static const uint32_t kNoNode = UINT32_MAX;
+
+// Set in firstParents once the first parent has been added to the sharing table
+static const uint32_t kIndexedParent = uint32_t(1) << 31;
+
+/**
+ * @brief Mixes a node key so that nearby keys land in distant slots
+ * @param key Sharing key of a node
+ * @return size_t Hash whose low bits select the slot
+ */
+static uint64_t slotHash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return key & ~kSlotIndexMask;
+}
+
+// Node::value of each operation, indexed by Op
+static const char* const kOpNames[] = {"FALSE", "TRUE", "", "NOT", "AND", "OR", "IMPLIES", "EQUIVALENT"};
+
+/**
+ * @brief Compiles the formulas into one shared DAG
+ * @param roots Parse trees of the formulas; they are not modified or owned
+ * @throws std::runtime_error if a tree contains an unknown operator
+ */
+BatchEvaluator::BatchEvaluator(const std::vector<Node*>& roots) {
+    std::set<std::string> variableSet;
+    for (Node* root : roots) {
+        Evaluator evaluator(root);
+        auto rootVariables = evaluator.collectVariables(root);
+        variableSet.insert(rootVariables.begin(), rootVariables.end());
+        labels.push_back(evaluator.nodeToString(root));
+    }
+    variables.assign(variableSet.begin(), variableSet.end());
+    for (size_t j = 0; j < variables.size(); ++j) {
+        variableNumbers.emplace(variables[j], static_cast<uint32_t>(j));
+    }
+    variableNodes.assign(variables.size(), kNoNode);
+
+    for (Node* root : roots) {
+        outputs.push_back(intern(root));
+    }
+}
+
+/**
+ * @brief Adds a subtree to the DAG, reusing existing identical nodes
+ * @param node Current node in the syntax tree
+ * @return uint32_t DAG index of the subtree
+ */
+uint32_t BatchEvaluator::intern(Node* node) {
+    if (!node) {
+        throw std::runtime_error("Invalid expression: Empty node encountered");
+    }
+
+    DagNode dagNode{Op::FALSE_CONST, {0, 0, 0}, 0, 0};
+    if (node->value == "TRUE" || node->value == "FALSE") {
+        return addConstant(node->value == "TRUE");
+    } else if (node->children.empty()) {
+        return addVariable(node->value);
+    } else if (node->value == "NOT") {
+        dagNode.op = Op::NOT;
+        dagNode.left = intern(node->children[0]);
+    } else {
+        if (node->value == "AND") dagNode.op = Op::AND;
+        else if (node->value == "OR") dagNode.op = Op::OR;
+        else if (node->value == "IMPLIES") dagNode.op = Op::IMPLIES;
+        else if (node->value == "EQUIVALENT") dagNode.op = Op::EQUIVALENT;
+        else throw std::runtime_error("Unknown operator: '" + node->value + "'");
+        dagNode.left = intern(node->children[0]);
+        dagNode.right = intern(node->children[1]);
+    }
+
+    return addNode(dagNode);
+}
+
+/**
+ * @brief Adds a variable node, numbering the variable when it is first seen
+ * @param name Variable name
+ * @return uint32_t DAG index of the variable
+ */
+uint32_t BatchEvaluator::addVariable(const std::string& name) {
+    auto number = variableNumbers.emplace(name, static_cast<uint32_t>(variables.size()));
+    if (number.second) {
+        variables.push_back(name);
+        variableNodes.push_back(kNoNode);
+    }
+
+    uint32_t variable = number.first->second;
+    if (variableNodes[variable] == kNoNode) {
+        variableNodes[variable] = pushNode({Op::VARIABLE, {0, 0, 0}, variable, 0});
+    }
+    return variableNodes[variable];
+}
+
+/**
+ * @brief Adds a constant node
+ * @param value The constant
+ * @return uint32_t DAG index of the constant
+ */
+uint32_t BatchEvaluator::addConstant(bool value) {
+    if (constantNodes[value] == kNoNode) {
+        constantNodes[value] = pushNode({value ? Op::TRUE_CONST : Op::FALSE_CONST, {0, 0, 0}, 0, 0});
+    }
+    return constantNodes[value];
+}
+
+/**
+ * @brief Adds an operator node, folding constants and sharing identical nodes
+ * @param op NOT or a binary operator
+ * @param left DAG index of the (first) operand
+ * @param right DAG index of the second operand; ignored for NOT
+ * @return uint32_t DAG index of the (possibly simplified) node
+ */
+uint32_t BatchEvaluator::addOperation(Op op, uint32_t left, uint32_t right) {
+    if (op < Op::NOT || left >= nodes.size() || (op != Op::NOT && right >= nodes.size())) {
+        throw std::runtime_error("Invalid DAG operation");
+    }
+    return addNode({op, {0, 0, 0}, left, op == Op::NOT ? 0 : right});
+}
+
+/**
+ * @brief Marks a node as the result of the next formula; its label is left empty
+ * @param node DAG index of the formula
+ */
+void BatchEvaluator::addOutput(uint32_t node) {
+    outputs.push_back(node);
+    labels.emplace_back();
+}
+
+/**
+ * @brief Renumbers the variables in sorted order, as the truth tables expect
+ */
+void BatchEvaluator::sortVariables() {
+    std::vector<uint32_t> order(variables.size());
+    for (size_t j = 0; j < order.size(); ++j) {
+        order[j] = static_cast<uint32_t>(j);
+    }
+    std::sort(order.begin(), order.end(),
+              [this](uint32_t a, uint32_t b) { return variables[a] < variables[b]; });
+
+    // Variable nodes are found through variableNodes rather than the sharing
+    // table, so only they and the numbering change
+    std::vector<uint32_t> numbers(order.size());
+    std::vector<std::string> sorted(order.size());
+    std::vector<uint32_t> sortedNodes(order.size());
+    for (size_t j = 0; j < order.size(); ++j) {
+        numbers[order[j]] = static_cast<uint32_t>(j);
+        sorted[j] = std::move(variables[order[j]]);
+        sortedNodes[j] = variableNodes[order[j]];
+        if (sortedNodes[j] != kNoNode) {
+            nodes[sortedNodes[j]].left = static_cast<uint32_t>(j);
+        }
+    }
+    for (auto& entry : variableNumbers) {
+        entry.second = numbers[entry.second];
+    }
+    variables.swap(sorted);
+    variableNodes.swap(sortedNodes);
+}
+
+/**
+ * @brief Rebuilds the sharing table with room for more nodes
+ * @param size Number of slots, a power of two above the number of indexed nodes
+ */
+void BatchEvaluator::rehash(size_t size) {
+    std::vector<uint64_t> old(size, 0);
+    old.swap(slots);
+
+    // Slots keep the hash bits that choose the new slot, so no node is read
+    size_t mask = size - 1;
+    for (uint64_t entry : old) {
+        if (entry == 0) continue;
+        size_t slot = (entry >> kSlotIndexBits) & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = entry;
+    }
+}
+
+/**
+ * @brief Sets every empty formula label to the formula's string form, as Evaluator::nodeToString prints it
+ */
+void BatchEvaluator::labelOutputs() {
+    for (size_t f = 0; f < outputs.size(); ++f) {
+        if (labels[f].empty()) {
+            appendString(outputs[f], labels[f]);
+        }
+    }
+}
+
+/**
+ * @brief Appends the string form of a node, as Evaluator::nodeToString prints it
+ * @param node DAG index of the subformula
+ * @param out String to append to
+ */
+void BatchEvaluator::appendString(uint32_t node, std::string& out) const {
+    const DagNode& dagNode = nodes[node];
+    switch (dagNode.op) {
+        case Op::FALSE_CONST:
+        case Op::TRUE_CONST:
+            out += kOpNames[static_cast<int>(dagNode.op)];
+            return;
+        case Op::VARIABLE:
+            out += variables[dagNode.left];
+            return;
+        case Op::NOT:
+            out += "NOT ";
+            appendString(dagNode.left, out);
+            return;
+        default:
+            break;
+    }
+
+    // Binary operands are parenthesized, and so is a negated right operand
+    bool wrapLeft = nodes[dagNode.left].op >= Op::AND;
+    bool wrapRight = nodes[dagNode.right].op >= Op::NOT;
+    if (wrapLeft) out += '(';
+    appendString(dagNode.left, out);
+    if (wrapLeft) out += ')';
+    out += ' ';
+    out += kOpNames[static_cast<int>(dagNode.op)];
+    out += ' ';
+    if (wrapRight) out += '(';
+    appendString(dagNode.right, out);
+    if (wrapRight) out += ')';
+}
+
+/**
+ * @brief Rebuilds the syntax tree of a node, for modes that show subexpressions
+ * @param node DAG index of the subformula
+ * @return Node* Root of the new tree, owned by the caller
+ */
+Node* BatchEvaluator::toTree(uint32_t node) const {
+    const DagNode& dagNode = nodes[node];
+    if (dagNode.op == Op::VARIABLE) {
+        return new Node(variables[dagNode.left]);
+    }
+
+    std::unique_ptr<Node> tree(new Node(kOpNames[static_cast<int>(dagNode.op)]));
+    if (dagNode.op >= Op::NOT) {
+        tree->children.push_back(toTree(dagNode.left));
+    }
+    if (dagNode.op >= Op::AND) {
+        tree->children.push_back(toTree(dagNode.right));
+    }
+    return tree.release();
+}
+
+/**
+ * @brief Adds a node to the DAG after folding constants, reusing an identical node
+ * @param dagNode The node to add; its operands are already in the DAG
+ * @return uint32_t DAG index of the (possibly simplified) node
+ */
+uint32_t BatchEvaluator::addNode(DagNode dagNode) {
+    // Constants are shared, so comparing indices avoids reading the operand nodes
+    auto isConst = [this](uint32_t id, Op value) { return id == constantNodes[value == Op::TRUE_CONST]; };
+    auto constant = [this](bool value) { return addConstant(value); };
+
+    switch (dagNode.op) {
+        case Op::NOT:
+            if (isConst(dagNode.left, Op::TRUE_CONST)) return constant(false);
+            if (isConst(dagNode.left, Op::FALSE_CONST)) return constant(true);
+            if (nodes[dagNode.left].op == Op::NOT) return nodes[dagNode.left].left;
+            break;
+        case Op::AND:
+            if (isConst(dagNode.left, Op::FALSE_CONST) || isConst(dagNode.right, Op::FALSE_CONST)) return constant(false);
+            if (isConst(dagNode.left, Op::TRUE_CONST)) return dagNode.right;
+            if (isConst(dagNode.right, Op::TRUE_CONST)) return dagNode.left;
+            break;
+        case Op::OR:
+            if (isConst(dagNode.left, Op::TRUE_CONST) || isConst(dagNode.right, Op::TRUE_CONST)) return constant(true);
+            if (isConst(dagNode.left, Op::FALSE_CONST)) return dagNode.right;
+            if (isConst(dagNode.right, Op::FALSE_CONST)) return dagNode.left;
+            break;
+        case Op::IMPLIES:
+            if (isConst(dagNode.left, Op::FALSE_CONST) || isConst(dagNode.right, Op::TRUE_CONST)) return constant(true);
+            if (isConst(dagNode.left, Op::TRUE_CONST)) return dagNode.right;
+            break;
+        case Op::EQUIVALENT:
+            if (isConst(dagNode.left, Op::TRUE_CONST)) return dagNode.right;
+            if (isConst(dagNode.right, Op::TRUE_CONST)) return dagNode.left;
+            break;
+        default:
+            break;
+    }
+
+    // Only the newer operand is consulted; it is usually the node built just before.
+    // While no node is built on it yet, the node is certainly new and needs no
+    // lookup, and it stays out of the sharing table until the operand is used
+    // again. Every node outside the table is thus the first parent of its newer operand.
+    uint32_t newer = dagNode.op == Op::NOT ? dagNode.left : std::max(dagNode.left, dagNode.right);
+    bool fresh = firstParents[newer] == kNoNode;
+    if (!fresh) {
+        if (!(firstParents[newer] & kIndexedParent)) {
+            indexNode(firstParents[newer]);
+            firstParents[newer] |= kIndexedParent;
+        }
+        uint32_t existing = findNode(dagNode);
+        if (existing != kNoNode) {
+            return existing;
+        }
+    }
+
+    uint32_t id = pushNode(dagNode);
+    if (fresh) {
+        firstParents[newer] = id;
+    } else {
+        indexNode(id);
+    }
+    return id;
+}
+
+/**
+ * @brief Appends a node without looking for an identical one
+ * @param dagNode The node to add; its operands are already in the DAG
+ * @return uint32_t DAG index of the new node
+ * @throws std::runtime_error if the DAG is full
+ */
+uint32_t BatchEvaluator::pushNode(const DagNode& dagNode) {
+    if (nodes.size() >= kMaxDagNodes) {
+        throw std::runtime_error("Too many distinct subformulas in batch");
+    }
+    nodes.push_back(dagNode);
+    firstParents.push_back(kNoNode);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+/**
+ * @brief Adds a node to the sharing table
+ * @param node DAG index of the node
+ */
+void BatchEvaluator::indexNode(uint32_t node) {
+    // Linear probing over a table kept at most half full
+    if (2 * (indexedNodes + 1) > slots.size()) {
+        rehash(std::max(kMinSlots, 2 * slots.size()));
+    }
+    uint64_t hash = slotHash(nodeKey(nodes[node]));
+    size_t mask = slots.size() - 1;
+    size_t slot = (hash >> kSlotIndexBits) & mask;
+    while (slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = hash | (node + 1);
+    ++indexedNodes;
+}
+
+/**
+ * @brief Looks up an operator node in the sharing table
+ * @param dagNode The node to find
+ * @return uint32_t DAG index of the identical node, or UINT32_MAX if there is none
+ */
+uint32_t BatchEvaluator::findNode(const DagNode& dagNode) const {
+    if (slots.empty()) return kNoNode;
+
+    uint64_t key = nodeKey(dagNode);
+    uint64_t hash = slotHash(key);
+    size_t mask = slots.size() - 1;
+    for (size_t slot = (hash >> kSlotIndexBits) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+        // Only a matching hash makes it worth reading the node
+        uint32_t existing = static_cast<uint32_t>((slots[slot] & kSlotIndexMask) - 1);
+        if ((slots[slot] & ~kSlotIndexMask) == hash && nodeKey(nodes[existing]) == key) {
+            return existing;
+        }
+    }
+    return kNoNode;
+}
+
+/**
+ * @brief Enumerates the shared assignment space once
+ * @return Columns for the variables followed by one result column per formula
+ * @throws std::runtime_error if there are too many variables to enumerate
+ */
+TruthColumns BatchEvaluator::evaluate() const {
+    TruthColumns table = evaluateDag(nodes.data(), nodes.size(), outputs.data(), outputs.size(),
+                                     variables.size());
+    table.labels = variables;
+    table.labels.insert(table.labels.end(), labels.begin(), labels.end());
+    return table;
+}
+
+/**
+ * @brief Enumerates the assignment space of a DAG held in plain arrays
+ * @param nodes Topologically ordered DAG nodes
+ * @param nodeCount Number of DAG nodes
+ * @param outputs DAG node of each formula
+ * @param outputCount Number of formulas
+ * @param variableCount Number of variables
+ * @return Columns for the variables followed by one result column per formula, without labels
+ * @throws std::runtime_error if there are too many variables to enumerate
+ */
+TruthColumns BatchEvaluator::evaluateDag(const DagNode* nodes, size_t nodeCount,
+                                         const uint32_t* outputs, size_t outputCount,
+                                         size_t variableCount) {
+    if (variableCount >= 64) {
+        throw std::runtime_error("Too many variables for a full truth table: " +
+                                 std::to_string(variableCount));
+    }
+
+    TruthColumns table;
+    table.numRows = size_t(1) << variableCount;
+
+    size_t numWords = (table.numRows + 63) / 64;
+    table.columns.assign(variableCount + outputCount, std::vector<uint64_t>(numWords));
+
+    // One row of stride words per DAG node, reused for every block
+    size_t stride = blockWords(nodeCount);
+    std::vector<uint64_t> scratch(nodeCount * stride);
+    for (size_t first = 0; first < numWords; first += stride) {
+        size_t count = std::min(stride, numWords - first);
+        evaluateBlock(nodes, nodeCount, nullptr, first, count, stride, scratch.data());
+
+        for (size_t w = 0; w < count; ++w) {
+            uint64_t mask = rowMask(table.numRows, first + w);
+            for (size_t j = 0; j < variableCount; ++j) {
+                table.columns[j][first + w] = variableWord(j, first + w) & mask;
+            }
+            for (size_t f = 0; f < outputCount; ++f) {
+                table.columns[variableCount + f][first + w] = scratch[outputs[f] * stride + w] & mask;
+            }
+        }
+    }
+
+    return table;
+}
+
+/**
+ * @brief Evaluates one formula over supplied assignments instead of enumerating them
+ * @param output Index of the formula
+ * @param inputs Packed column of each variable, in getVariables() order, 64 rows per word
+ * @param numRows Number of rows held in the columns
+ * @param scratch Working storage, reused between calls to avoid reallocating it
+ * @return Packed result column with unused tail bits cleared
+ */
+std::vector<uint64_t> BatchEvaluator::evaluateColumns(size_t output,
+                                                      const std::vector<const uint64_t*>& inputs,
+                                                      size_t numRows,
+                                                      std::vector<uint64_t>& scratch) const {
+    if (inputs.size() != variables.size()) {
+        throw std::runtime_error("Expected " + std::to_string(variables.size()) +
+                                 " assignment columns, got " + std::to_string(inputs.size()));
+    }
+
+    size_t numWords = (numRows + 63) / 64;
+    size_t stride = blockWords(nodes.size());
+    scratch.resize(nodes.size() * stride);
+
+    std::vector<uint64_t> result(numWords);
+    for (size_t first = 0; first < numWords; first += stride) {
+        size_t count = std::min(stride, numWords - first);
+        evaluateBlock(nodes.data(), nodes.size(), inputs.data(), first, count, stride, scratch.data());
+        for (size_t w = 0; w < count; ++w) {
+            result[first + w] = scratch[outputs[output] * stride + w] & rowMask(numRows, first + w);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Evaluates one formula over part of the truth table
+ * @param output Index of the formula
+ * @param firstWord Index of the first 64-row word to evaluate
+ * @param numWords Number of 64-row words to evaluate
+ * @param scratch Working storage, reused between calls to avoid reallocating it
+ * @return The result words for rows [64 * firstWord, 64 * (firstWord + numWords)), unused tail bits cleared
+ * @throws std::runtime_error if there are too many variables to enumerate
+ */
+std::vector<uint64_t> BatchEvaluator::evaluateRange(size_t output, size_t firstWord, size_t numWords,
+                                                    std::vector<uint64_t>& scratch) const {
+    if (variables.size() >= 64) {
+        throw std::runtime_error("Too many variables for a full truth table: " +
+                                 std::to_string(variables.size()));
+    }
+
+    size_t numRows = size_t(1) << variables.size();
+    size_t stride = blockWords(nodes.size());
+    scratch.resize(nodes.size() * stride);
+
+    std::vector<uint64_t> result(numWords);
+    for (size_t done = 0; done < numWords; done += stride) {
+        size_t count = std::min(stride, numWords - done);
+        evaluateBlock(nodes.data(), nodes.size(), nullptr, firstWord + done, count, stride, scratch.data());
+        for (size_t w = 0; w < count; ++w) {
+            result[done + w] = scratch[outputs[output] * stride + w] & rowMask(numRows, firstWord + done + w);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Evaluates a block of 64-row words for every DAG node
+ * @param nodes Topologically ordered DAG nodes
+ * @param nodeCount Number of DAG nodes
+ * @param inputs Packed column of each variable; nullptr enumerates the truth table rows
+ * @param first Index of the first word of the block
+ * @param count Number of words in the block, at most stride
+ * @param stride Words reserved per node in scratch
+ * @param scratch Receives the block of node i at scratch[i * stride]
+ */
+void BatchEvaluator::evaluateBlock(const DagNode* nodes, size_t nodeCount, const uint64_t* const* inputs,
+                                   size_t first, size_t count, size_t stride, uint64_t* scratch) {
+    for (size_t i = 0; i < nodeCount; ++i) {
+        const DagNode& node = nodes[i];
+        uint64_t* out = &scratch[i * stride];
+        const uint64_t* left = node.op >= Op::NOT ? &scratch[node.left * stride] : nullptr;
+        const uint64_t* right = node.op >= Op::AND ? &scratch[node.right * stride] : nullptr;
+
+        switch (node.op) {
+            case Op::FALSE_CONST:
+                for (size_t w = 0; w < count; ++w) out[w] = 0;
+                break;
+            case Op::TRUE_CONST:
+                for (size_t w = 0; w < count; ++w) out[w] = ~uint64_t(0);
+                break;
+            case Op::VARIABLE:
+                if (inputs) {
+                    const uint64_t* column = inputs[node.left] + first;
+                    for (size_t w = 0; w < count; ++w) out[w] = column[w];
+                } else {
+                    for (size_t w = 0; w < count; ++w) out[w] = variableWord(node.left, first + w);
+                }
+                break;
+            case Op::NOT:
+                for (size_t w = 0; w < count; ++w) out[w] = ~left[w];
+                break;
+            case Op::AND:
+                for (size_t w = 0; w < count; ++w) out[w] = left[w] & right[w];
+                break;
+            case Op::OR:
+                for (size_t w = 0; w < count; ++w) out[w] = left[w] | right[w];
+                break;
+            case Op::IMPLIES:
+                for (size_t w = 0; w < count; ++w) out[w] = ~left[w] | right[w];
+                break;
+            case Op::EQUIVALENT:
+                for (size_t w = 0; w < count; ++w) out[w] = ~(left[w] ^ right[w]);
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Chooses the block size for a DAG so its scratch space stays bounded
+ * @param nodeCount Number of DAG nodes
+ * @return size_t Words per block, between 1 and 64
+ */
+size_t BatchEvaluator::blockWords(size_t nodeCount) {
+    return std::max<size_t>(1, std::min(kMaxBlockWords, kScratchWords / std::max<size_t>(1, nodeCount)));
+}
@@ -0,0 +1,106 @@
+#include <atomic>
+#include <bitset>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <utility>
+#include "../include/Checker.h"
+
+/**
+ * @brief Constructs a checker for an expression
+ * @param root Root of the expression's syntax tree; it is only read while compiling
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ */
+Checker::Checker(Node* root, size_t threads) : Checker(BatchEvaluator({root}), 0, threads) {
+}
+
+/**
+ * @brief Constructs a checker for one formula of a compiled DAG
+ * @param dag The DAG, with its variables sorted
+ * @param output Index of the formula in the DAG
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ */
+Checker::Checker(BatchEvaluator dag, size_t output, size_t threads)
+    : dag(std::move(dag)), output(output), threads(threads) {
+    if (this->threads == 0) {
+        this->threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+}
+
+/**
+ * @brief Finds the lowest truth table row where the expression has the given value
+ * @param value The result to look for: true for a witness, false for a counterexample
+ * @param row Set to the row index when one is found
+ * @return bool False if no row has that result
+ * @throws std::runtime_error if there are too many variables to enumerate
+ */
+bool Checker::findRow(bool value, size_t& row) {
+    const std::vector<std::string>& variables = dag.getVariables();
+    if (variables.size() >= 64) {
+        throw std::runtime_error("Too many variables for a full truth table: " +
+                                 std::to_string(variables.size()));
+    }
+    const size_t numRows = size_t(1) << variables.size();
+    const size_t totalWords = (numRows + 63) / 64;
+    const size_t totalBlocks = (totalWords + kBlockWords - 1) / kBlockWords;
+    const size_t notFound = SIZE_MAX;
+
+    std::atomic<size_t> nextBlock{0};
+    std::atomic<size_t> bestRow{notFound};     // Lowest matching row found so far
+    std::atomic<size_t> words{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        try {
+            // Each thread has its own scratch space; the DAG is only read
+            std::vector<uint64_t> scratch;
+            while (!failed.load(std::memory_order_relaxed)) {
+                size_t block = nextBlock.fetch_add(1, std::memory_order_relaxed);
+                size_t firstWord = block * kBlockWords;
+                // Blocks past a found row cannot hold a lower one
+                if (block >= totalBlocks || firstWord * 64 > bestRow.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                size_t numWords = std::min(kBlockWords, totalWords - firstWord);
+                std::vector<uint64_t> column = dag.evaluateRange(output, firstWord, numWords, scratch);
+                words.fetch_add(numWords, std::memory_order_relaxed);
+
+                for (size_t word = 0; word < numWords; ++word) {
+                    uint64_t matches = value ? column[word]
+                                             : ~column[word] & rowMask(numRows, firstWord + word);
+                    if (!matches) continue;
+
+                    size_t found = (firstWord + word) * 64 +
+                                   std::bitset<64>((matches & (~matches + 1)) - 1).count();
+                    size_t best = bestRow.load(std::memory_order_relaxed);
+                    while (found < best && !bestRow.compare_exchange_weak(best, found)) {
+                    }
+                    break;
+                }
+            }
+        } catch (...) {
+            if (!failed.exchange(true)) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    size_t count = std::min(threads, totalBlocks);
+    for (size_t i = 1; i < count; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    searched = words.load();
+    row = bestRow.load();
+    return row != notFound;
+}
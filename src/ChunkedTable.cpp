@@ -0,0 +1,142 @@
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include "../include/ChunkedTable.h"
+
+/**
+ * @brief Constructs a writer for one table directory
+ * @param directory Directory receiving the manifest and chunk files
+ * @param maxMemory Budget in bytes for the columns of one chunk
+ */
+ChunkedTableWriter::ChunkedTableWriter(const std::string& directory, size_t maxMemory)
+    : directory(directory), maxMemory(maxMemory) {}
+
+/**
+ * @brief Generates and writes every missing chunk of an expression's truth table
+ * @param evaluator Evaluator holding the parsed expression
+ * @param log Stream receiving a one-line summary
+ * @throws std::runtime_error if the budget is too small or a file cannot be written
+ */
+void ChunkedTableWriter::write(Evaluator& evaluator, std::ostream& log) {
+    std::vector<std::string> variables = evaluator.tableVariables();
+    std::vector<std::string> labels = evaluator.columnLabels(variables);
+    size_t totalRows = size_t(1) << variables.size();
+    size_t totalWords = (totalRows + 63) / 64;
+
+    // Every distinct subexpression holds one word per 64 rows while a chunk is built
+    size_t bytesPerWord = evaluator.countColumns() * sizeof(uint64_t);
+    if (maxMemory < bytesPerWord) {
+        throw std::runtime_error("Memory budget of " + std::to_string(maxMemory) +
+                                 " bytes cannot hold 64 rows of " +
+                                 std::to_string(evaluator.countColumns()) + " columns");
+    }
+    size_t chunkWords = 1;
+    while (chunkWords * 2 <= totalWords && chunkWords * 2 * bytesPerWord <= maxMemory) {
+        chunkWords *= 2;
+    }
+    size_t numChunks = totalWords / chunkWords;
+
+    std::ostringstream manifest;
+    manifest << "formula: " << labels.back() << "\n";
+    manifest << "variables:";
+    for (const auto& var : variables) manifest << " " << var;
+    manifest << "\n";
+    manifest << "rows: " << totalRows << "\n";
+    manifest << "rows_per_chunk: " << std::min(chunkWords * 64, totalRows) << "\n";
+    manifest << "words_per_chunk: " << chunkWords << "\n";
+    manifest << "chunks: " << numChunks << "\n";
+    for (size_t i = variables.size(); i < labels.size(); ++i) {
+        manifest << "column: " << labels[i] << "\n";
+    }
+
+    // Chunks of an earlier run are only reused when it produced the same manifest
+    std::filesystem::create_directories(directory);
+    std::string manifestPath = (std::filesystem::path(directory) / "manifest.txt").string();
+    std::string previous;
+    {
+        std::ifstream existing(manifestPath, std::ios::binary);
+        std::ostringstream contents;
+        contents << existing.rdbuf();
+        previous = contents.str();
+    }
+    bool resume = previous == manifest.str();
+    if (!resume) {
+        std::ofstream out(manifestPath, std::ios::binary | std::ios::trunc);
+        out << manifest.str();
+        if (!out) {
+            throw std::runtime_error("Could not write manifest: " + manifestPath);
+        }
+    }
+
+    size_t chunkBytes = (labels.size() - variables.size()) * chunkWords * sizeof(uint64_t);
+    size_t resumed = 0;
+    for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+        std::string path = chunkPath(chunk);
+        std::error_code error;
+        if (resume && std::filesystem::file_size(path, error) == chunkBytes && !error) {
+            ++resumed;
+            continue;
+        }
+
+        TruthColumns table = evaluator.generateTruthChunk(chunk * chunkWords, chunkWords);
+
+        // Write under a temporary name so a partial chunk is never mistaken for a finished one
+        std::string partialPath = path + ".tmp";
+        {
+            std::ofstream out(partialPath, std::ios::binary | std::ios::trunc);
+            for (size_t i = variables.size(); i < table.columns.size(); ++i) {
+                out.write(reinterpret_cast<const char*>(table.columns[i].data()),
+                          table.columns[i].size() * sizeof(uint64_t));
+            }
+            if (!out) {
+                throw std::runtime_error("Could not write chunk file: " + partialPath);
+            }
+        }
+        std::filesystem::rename(partialPath, path);
+    }
+
+    log << "Wrote " << totalRows << " rows in " << numChunks << " chunk(s) of "
+        << std::min(chunkWords * 64, totalRows) << " rows to " << directory;
+    if (resumed > 0) log << " (" << resumed << " resumed)";
+    log << std::endl;
+}
+
+/**
+ * @brief Builds the path of a chunk file
+ * @param chunk Index of the chunk
+ * @return std::string The chunk file path
+ */
+std::string ChunkedTableWriter::chunkPath(size_t chunk) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "chunk_%06zu.bin", chunk);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+/**
+ * @brief Parses a memory size such as "512K", "256M" or "2G"
+ * @param text The size, in bytes unless suffixed with K, M or G
+ * @return size_t The size in bytes
+ * @throws std::runtime_error if the text is not a valid size
+ */
+size_t parseMemorySize(const std::string& text) {
+    size_t digits = 0;
+    while (digits < text.length() && std::isdigit(static_cast<unsigned char>(text[digits]))) {
+        ++digits;
+    }
+    if (digits == 0 || digits > 15 || text.length() > digits + 1) {
+        throw std::runtime_error("Invalid memory size: '" + text + "'");
+    }
+
+    size_t size = std::stoull(text.substr(0, digits));
+    if (digits == text.length()) return size;
+
+    switch (std::toupper(static_cast<unsigned char>(text[digits]))) {
+        case 'K': return size << 10;
+        case 'M': return size << 20;
+        case 'G': return size << 30;
+        default: throw std::runtime_error("Invalid memory size: '" + text + "'");
+    }
+}
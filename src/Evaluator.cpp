@@ -1,8 +1,27 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <cctype>
 #include "../include/Evaluator.h"
 
+// Cached columns are dropped once they take more than this many bytes. A column
+// holds 2^n bits for n variables, so a count limit would not bound the memory.
+static const size_t kMaxCachedBytes = size_t(256) << 20;
+
+/**
+ * @brief Orders subexpressions for display, simplest first
+ * @param a First subexpression
+ * @param b Second subexpression
+ * @return True if a should be displayed before b
+ */
+static bool orderSubExpressions(const std::string& a, const std::string& b) {
+    // Count spaces as a measure of expression complexity
+    int complexityA = std::count(a.begin(), a.end(), ' ');
+    int complexityB = std::count(b.begin(), b.end(), ' ');
+    if (complexityA != complexityB) return complexityA < complexityB;
+    return a < b;
+}
+
 /**
  * @brief Constructs an Evaluator with a given syntax tree root
  * @param root Pointer to the root node of the syntax tree
@@ -68,6 +87,79 @@ bool Evaluator::evaluateWithTracking(Node* node, const std::unordered_map<std::s
     return result;
 }
 
+/**
+ * @brief Evaluates a logical expression for 64 assignments at once
+ * @param node Current node in the syntax tree
+ * @param values Map of variable assignments, one assignment per bit
+ * @return Word holding the result of each of the 64 assignments
+ */
+uint64_t Evaluator::evaluateBits(Node* node, const std::unordered_map<std::string, uint64_t>& values) {
+    if (!node) {
+        throw std::runtime_error("Invalid expression: Empty node encountered");
+    }
+
+    // Handle constants
+    if (node->value == "TRUE") return ~uint64_t(0);
+    if (node->value == "FALSE") return 0;
+
+    // Handle variables
+    auto it = values.find(node->value);
+    if (it != values.end()) {
+        return it->second;
+    }
+
+    // Handle NOT operator
+    if (node->value == "NOT") {
+        return ~evaluateBits(node->children[0], values);
+    }
+
+    // Handle binary operators, skipping the right operand when the left decides all 64 rows
+    uint64_t leftResult = evaluateBits(node->children[0], values);
+    if (node->value == "AND" && leftResult == 0) return 0;
+    if (node->value == "OR" && leftResult == ~uint64_t(0)) return leftResult;
+    if (node->value == "IMPLIES" && leftResult == 0) return ~uint64_t(0);
+    uint64_t rightResult = evaluateBits(node->children[1], values);
+
+    if (node->value == "AND") return leftResult & rightResult;
+    if (node->value == "OR") return leftResult | rightResult;
+    if (node->value == "IMPLIES") return ~leftResult | rightResult;
+    if (node->value == "EQUIVALENT") return ~(leftResult ^ rightResult);
+    throw std::runtime_error("Unknown operator: '" + node->value + "'");
+}
+
+/**
+ * @brief Generates the packed result column of the logical expression
+ * @param variables Filled with the sorted variables; variable j is bit j of the row index
+ * @return One bit per truth table row, 64 rows per word, unused tail bits cleared
+ */
+std::vector<uint64_t> Evaluator::generateResultColumn(std::vector<std::string>& variables) {
+    variables = tableVariables();
+    size_t numRows = size_t(1) << variables.size();
+    return generateResultRange(0, (numRows + 63) / 64);
+}
+
+/**
+ * @brief Generates part of the packed result column without tracking subexpressions
+ * @param firstWord Index of the first 64-row word to evaluate
+ * @param numWords Number of 64-row words to evaluate
+ * @return The result words for rows [64 * firstWord, 64 * (firstWord + numWords))
+ */
+std::vector<uint64_t> Evaluator::generateResultRange(size_t firstWord, size_t numWords) {
+    std::vector<std::string> variables = tableVariables();
+    size_t numRows = size_t(1) << variables.size();
+    std::vector<uint64_t> column(numWords);
+
+    std::unordered_map<std::string, uint64_t> values;
+    for (size_t word = 0; word < numWords; ++word) {
+        for (size_t j = 0; j < variables.size(); ++j) {
+            values[variables[j]] = variableWord(j, firstWord + word);
+        }
+        column[word] = evaluateBits(root, values) & rowMask(numRows, firstWord + word);
+    }
+
+    return column;
+}
+
 /**
  * @brief Collects all variables in the expression tree
  * @param node Current node in the syntax tree
@@ -75,18 +167,29 @@ bool Evaluator::evaluateWithTracking(Node* node, const std::unordered_map<std::s
  */
 std::set<std::string> Evaluator::collectVariables(Node* node) {
     std::set<std::string> variables;
-    if (!node) return variables;
+    collectVariables(node, variables);
+    return variables;
+}
 
-    if (node->value.length() == 1 && std::isupper(node->value[0])) {
+/**
+ * @brief Adds the variables of a subtree to a set
+ * @param node Current node in the syntax tree
+ * @param variables Set receiving the variable names
+ */
+void Evaluator::collectVariables(Node* node, std::set<std::string>& variables) {
+    if (!node) return;
+
+    // A variable is an uppercase letter, optionally followed by digits (P, X12)
+    if (node->children.empty() && !node->value.empty() &&
+        std::isupper(static_cast<unsigned char>(node->value[0])) &&
+        std::all_of(node->value.begin() + 1, node->value.end(),
+                    [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
         variables.insert(node->value);
     }
 
     for (auto child : node->children) {
-        auto childVars = collectVariables(child);
-        variables.insert(childVars.begin(), childVars.end());
+        collectVariables(child, variables);
     }
-
-    return variables;
 }
 
 /**
@@ -97,9 +200,7 @@ std::pair<std::vector<std::pair<std::unordered_map<std::string, bool>, std::unor
           std::vector<std::string>>
 Evaluator::generateTruthTable() {
     try {
-        std::set<std::string> variableSet = collectVariables(root);
-        std::vector<std::string> variables(variableSet.begin(), variableSet.end());
-        std::sort(variables.begin(), variables.end());  // Sort variables alphabetically
+        std::vector<std::string> variables = tableVariables();  // Sorted alphabetically
         std::string fullExpression = nodeToString(root);
 
         // Generate truth table
@@ -115,15 +216,6 @@ Evaluator::generateTruthTable() {
         std::unordered_map<std::string, bool> firstResults;
         evaluateWithTracking(root, firstValues, firstResults);
 
-        // Order subexpressions based on complexity
-        auto orderSubExpressions = [](const std::string& a, const std::string& b) {
-            // Count spaces as a measure of expression complexity
-            int complexityA = std::count(a.begin(), a.end(), ' ');
-            int complexityB = std::count(b.begin(), b.end(), ' ');
-            if (complexityA != complexityB) return complexityA < complexityB;
-            return a < b;
-        };
-
         // Collect and order subexpressions
         for (const auto& [expr, _] : firstResults) {
             if (expr != fullExpression &&
@@ -134,11 +226,11 @@ Evaluator::generateTruthTable() {
         std::sort(subExpressions.begin(), subExpressions.end(), orderSubExpressions);
 
         // Generate all combinations
-        size_t numCombinations = std::pow(2, variables.size());
+        size_t numCombinations = size_t(1) << variables.size();
         for (size_t i = 0; i < numCombinations; ++i) {
             std::unordered_map<std::string, bool> values;
             for (size_t j = 0; j < variables.size(); ++j) {
-                values[variables[j]] = (i & (1 << j)) != 0;
+                values[variables[j]] = ((i >> j) & 1) != 0;
             }
 
             std::unordered_map<std::string, bool> subResults;
@@ -157,6 +249,319 @@ Evaluator::generateTruthTable() {
     }
 }
 
+/**
+ * @brief Generates the truth table as packed columns
+ * @param cache Optional cache of subexpression columns; columns found there are
+ *              reused and newly computed ones are added
+ * @return Columns for the variables, the subexpressions and the full expression
+ */
+TruthColumns Evaluator::generateTruthColumns(ColumnCache* cache) {
+    try {
+        ColumnCache localCache;
+        if (!cache) cache = &localCache;
+
+        std::vector<std::string> variables = tableVariables();
+
+        // Row order depends on the variables, so a different set invalidates the cache
+        if (cache->variables != variables || cache->firstWord != 0) {
+            cache->variables = variables;
+            cache->firstWord = 0;
+            cache->columns.clear();
+            cache->bytes = 0;
+        }
+
+        TruthColumns table;
+        table.numRows = size_t(1) << variables.size();
+        buildColumn(root, (table.numRows + 63) / 64, table.numRows, *cache);
+
+        std::unordered_map<std::string, Node*> labelNodes;
+        collectLabelNodes(root, labelNodes);
+        table.labels = columnLabels(variables);
+        for (const auto& label : table.labels) {
+            table.columns.push_back(cache->columns.at(structureKey(labelNodes.at(label))));
+        }
+
+        // The table holds its own copies, so an oversized cache can be dropped
+        // now instead of being kept until the next input
+        if (cache->bytes > kMaxCachedBytes) {
+            cache->columns.clear();
+            cache->bytes = 0;
+        }
+
+        return table;
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to generate truth table: " + std::string(e.what()));
+    }
+}
+
+/**
+ * @brief Generates one chunk of the truth table as packed columns
+ * @param firstWord Index of the first 64-row word of the chunk
+ * @param numWords Number of 64-row words in the chunk
+ * @return Columns restricted to the chunk; firstRow and numRows locate it in the table
+ */
+TruthColumns Evaluator::generateTruthChunk(size_t firstWord, size_t numWords) {
+    try {
+        ColumnCache cache;
+        cache.variables = tableVariables();
+        cache.firstWord = firstWord;
+
+        size_t totalRows = size_t(1) << cache.variables.size();
+        TruthColumns table;
+        table.firstRow = std::min(firstWord * 64, totalRows);
+        table.numRows = std::min(numWords * 64, totalRows - table.firstRow);
+        buildColumn(root, numWords, totalRows, cache);
+
+        std::unordered_map<std::string, Node*> labelNodes;
+        collectLabelNodes(root, labelNodes);
+        table.labels = columnLabels(cache.variables);
+        for (const auto& label : table.labels) {
+            table.columns.push_back(cache.columns.at(structureKey(labelNodes.at(label))));
+        }
+
+        return table;
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to generate truth table chunk: " + std::string(e.what()));
+    }
+}
+
+/**
+ * @brief Generates only the requested truth table columns
+ * @param selected Labels of the columns to compute, as shown in the full truth table
+ * @return Columns for the variables followed by the requested columns
+ * @throws std::runtime_error if a label is not a subexpression of the tree
+ */
+TruthColumns Evaluator::generateSelectedColumns(const std::vector<std::string>& selected) {
+    std::vector<std::string> variables = tableVariables();
+
+    TruthColumns table;
+    table.numRows = size_t(1) << variables.size();
+    table.labels = variables;
+
+    std::vector<Node*> nodes;
+    for (const auto& label : selected) {
+        Node* node = findSubExpression(root, label);
+        if (!node) {
+            throw std::runtime_error("Unknown column: '" + label + "'");
+        }
+        // Variable columns are always shown, and each column only once
+        if (std::find(table.labels.begin(), table.labels.end(), label) != table.labels.end()) {
+            continue;
+        }
+        table.labels.push_back(label);
+        nodes.push_back(node);
+    }
+
+    size_t numWords = (table.numRows + 63) / 64;
+    table.columns.assign(table.labels.size(), std::vector<uint64_t>(numWords));
+
+    // Each requested subtree is evaluated without tracking, so no other column is stored
+    std::unordered_map<std::string, uint64_t> values;
+    for (size_t word = 0; word < numWords; ++word) {
+        uint64_t mask = rowMask(table.numRows, word);
+        for (size_t j = 0; j < variables.size(); ++j) {
+            values[variables[j]] = variableWord(j, word);
+            table.columns[j][word] = values[variables[j]] & mask;
+        }
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            table.columns[variables.size() + i][word] = evaluateBits(nodes[i], values) & mask;
+        }
+    }
+
+    return table;
+}
+
+/**
+ * @brief Finds the subtree whose string form matches a column label
+ * @param node Current node in the syntax tree
+ * @param label The column label to look for
+ * @return The matching node, or nullptr if there is none
+ */
+Node* Evaluator::findSubExpression(Node* node, const std::string& label) {
+    // Resolved like the full truth table, so both show the same subtree under a label
+    std::unordered_map<std::string, Node*> labelNodes;
+    collectLabelNodes(node, labelNodes);
+    auto found = labelNodes.find(label);
+    return found != labelNodes.end() ? found->second : nullptr;
+}
+
+/**
+ * @brief Counts the distinct columns (variables and subexpressions) of the truth table
+ * @return Number of packed columns held while generating the table
+ */
+size_t Evaluator::countColumns() {
+    // Columns are held per distinct subtree, which may be more than there are labels
+    std::set<std::string> structures;
+    collectStructures(root, structures);
+    return structures.size();
+}
+
+/**
+ * @brief Collects the sorted variables of the table and checks they can be enumerated
+ * @return The variables; variable j is bit j of the row index
+ */
+std::vector<std::string> Evaluator::tableVariables() {
+    std::set<std::string> variableSet = collectVariables(root);
+    if (variableSet.size() >= 64) {
+        throw std::runtime_error("Too many variables for a full truth table: " +
+                                 std::to_string(variableSet.size()));
+    }
+    return std::vector<std::string>(variableSet.begin(), variableSet.end());
+}
+
+/**
+ * @brief Lists the truth table columns in display order
+ * @param variables The sorted variables of the table
+ * @return Variables, then subexpressions by complexity, then the full expression
+ */
+std::vector<std::string> Evaluator::columnLabels(const std::vector<std::string>& variables) {
+    std::string fullExpression = nodeToString(root);
+    std::set<std::string> expressions;
+    collectSubExpressions(root, expressions);
+
+    std::vector<std::string> subExpressions;
+    for (const auto& expr : expressions) {
+        if (expr != fullExpression &&
+            std::find(variables.begin(), variables.end(), expr) == variables.end()) {
+            subExpressions.push_back(expr);
+        }
+    }
+    std::sort(subExpressions.begin(), subExpressions.end(), orderSubExpressions);
+
+    // Same column order as generateTruthTable
+    std::vector<std::string> labels = variables;
+    labels.insert(labels.end(), subExpressions.begin(), subExpressions.end());
+    labels.push_back(fullExpression);
+    return labels;
+}
+
+/**
+ * @brief Collects the string form of every subexpression in the tree
+ * @param node Current node in the syntax tree
+ * @param expressions Set receiving the subexpressions
+ */
+void Evaluator::collectSubExpressions(Node* node, std::set<std::string>& expressions) {
+    if (!node) return;
+    expressions.insert(nodeToString(node));
+    for (auto child : node->children) {
+        collectSubExpressions(child, expressions);
+    }
+}
+
+/**
+ * @brief Collects the structural key of every subtree in the tree
+ * @param node Current node in the syntax tree
+ * @param structures Set receiving the keys
+ */
+void Evaluator::collectStructures(Node* node, std::set<std::string>& structures) {
+    if (!node) return;
+    structures.insert(structureKey(node));
+    for (auto child : node->children) {
+        collectStructures(child, structures);
+    }
+}
+
+/**
+ * @brief Maps each column label to the subtree shown under it
+ * @param node Current node in the syntax tree
+ * @param labelNodes Map receiving label -> subtree; when differently shaped subtrees print
+ *                   alike, the label shows the same one as in evaluateWithTracking: the
+ *                   last negation evaluated, otherwise the first binary operation
+ */
+void Evaluator::collectLabelNodes(Node* node, std::unordered_map<std::string, Node*>& labelNodes) {
+    if (!node) return;
+    for (auto child : node->children) {
+        collectLabelNodes(child, labelNodes);
+    }
+    if (node->children.size() == 2) {
+        labelNodes.emplace(nodeToString(node), node);
+    } else {
+        labelNodes[nodeToString(node)] = node;
+    }
+}
+
+/**
+ * @brief Builds a key that identifies a subtree by its shape
+ * @param node Current node in the syntax tree
+ * @return Fully parenthesized prefix form; unlike nodeToString it never maps two
+ *         differently shaped trees (such as NOT (P AND Q) and (NOT P) AND Q) to one string
+ */
+std::string Evaluator::structureKey(Node* node) {
+    if (!node) return "";
+    if (node->children.empty()) return node->value;
+
+    std::string key = "(" + node->value;
+    for (auto child : node->children) {
+        key += " " + structureKey(child);
+    }
+    return key + ")";
+}
+
+/**
+ * @brief Computes the packed column of a subtree, reusing cached columns
+ * @param node Current node in the syntax tree
+ * @param numWords Number of 64-row words to compute, starting at cache.firstWord
+ * @param totalRows Number of rows in the whole truth table
+ * @param cache Cache consulted before and filled after computing a column
+ * @return Reference to the cached column of the subtree
+ */
+const std::vector<uint64_t>& Evaluator::buildColumn(Node* node, size_t numWords, size_t totalRows,
+                                                    ColumnCache& cache) {
+    if (!node) {
+        throw std::runtime_error("Invalid expression: Empty node encountered");
+    }
+
+    std::string key = structureKey(node);
+    auto cached = cache.columns.find(key);
+    if (cached != cache.columns.end()) {
+        return cached->second;
+    }
+
+    std::vector<uint64_t> column(numWords);
+
+    if (node->children.empty()) {
+        // Constants and variables
+        auto var = std::find(cache.variables.begin(), cache.variables.end(), node->value);
+        if (node->value != "TRUE" && node->value != "FALSE" && var == cache.variables.end()) {
+            throw std::runtime_error("Unknown variable: '" + node->value + "'");
+        }
+        size_t index = var - cache.variables.begin();
+        for (size_t word = 0; word < numWords; ++word) {
+            size_t tableWord = cache.firstWord + word;
+            uint64_t bits = 0;
+            if (node->value == "TRUE") bits = ~uint64_t(0);
+            else if (var != cache.variables.end()) bits = variableWord(index, tableWord);
+            column[word] = bits & rowMask(totalRows, tableWord);
+        }
+    } else if (node->value == "NOT") {
+        const std::vector<uint64_t>& operand = buildColumn(node->children[0], numWords, totalRows, cache);
+        for (size_t word = 0; word < numWords; ++word) {
+            column[word] = ~operand[word] & rowMask(totalRows, cache.firstWord + word);
+        }
+    } else {
+        const std::vector<uint64_t>& left = buildColumn(node->children[0], numWords, totalRows, cache);
+        const std::vector<uint64_t>& right = buildColumn(node->children[1], numWords, totalRows, cache);
+        if (node->value == "AND") {
+            for (size_t word = 0; word < numWords; ++word) column[word] = left[word] & right[word];
+        } else if (node->value == "OR") {
+            for (size_t word = 0; word < numWords; ++word) column[word] = left[word] | right[word];
+        } else if (node->value == "IMPLIES") {
+            for (size_t word = 0; word < numWords; ++word) {
+                column[word] = (~left[word] | right[word]) & rowMask(totalRows, cache.firstWord + word);
+            }
+        } else if (node->value == "EQUIVALENT") {
+            for (size_t word = 0; word < numWords; ++word) {
+                column[word] = ~(left[word] ^ right[word]) & rowMask(totalRows, cache.firstWord + word);
+            }
+        } else {
+            throw std::runtime_error("Unknown operator: '" + node->value + "'");
+        }
+    }
+
+    cache.bytes += key.size() + column.size() * sizeof(uint64_t);
+    return cache.columns.emplace(key, std::move(column)).first->second;
+}
+
 /**
  * @brief Converts a node and its subtree to a string representation
  * @param node Current node in the syntax tree
@@ -206,3 +611,32 @@ void print_tree(Node* node, int level) {
         print_tree(child, level + 1);
     }
 }
+
+/**
+ * @brief Returns one 64-row word of a variable's truth table column
+ * @param j Index of the variable; its value in row i is bit j of i
+ * @param word Index of the word, covering rows [64 * word, 64 * word + 63]
+ * @return Word with bit k set when the variable is true in row 64 * word + k
+ */
+uint64_t variableWord(size_t j, size_t word) {
+    // Within a word, the low six variables follow fixed alternating patterns
+    static const uint64_t patterns[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    if (j < 6) return patterns[j];
+    return ((word >> (j - 6)) & 1) ? ~uint64_t(0) : 0;
+}
+
+/**
+ * @brief Returns the mask of rows that exist within one word of a column
+ * @param numRows Total number of rows in the column
+ * @param word Index of the word
+ * @return Word with bit k set when row 64 * word + k is below numRows
+ */
+uint64_t rowMask(size_t numRows, size_t word) {
+    size_t first = word * 64;
+    if (first >= numRows) return 0;
+    if (numRows - first >= 64) return ~uint64_t(0);
+    return (uint64_t(1) << (numRows - first)) - 1;
+}
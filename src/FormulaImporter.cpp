@@ -0,0 +1,401 @@
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include "../include/FormulaImporter.h"
+
+// DIMACS variables up to this number have their literal nodes cached by number
+static const size_t kMaxCachedVariable = size_t(1) << 24;
+
+// Marks a literal that has no DAG node yet
+static const uint32_t kNoNode = UINT32_MAX;
+
+/**
+ * @brief Constructs an importer and detects the file format
+ * @param input The stream to read formulas from
+ */
+FormulaImporter::FormulaImporter(std::istream& input)
+    : reader(input), cursor(nullptr), lineEnd(nullptr),
+      format(Format::INFIX), finished(false), declaredVariables(0), declaredClauses(0),
+      clauses(0), lookahead(TokenKind::END), dag(nullptr) {
+    if (skipBlank('\0') && (*cursor == 'c' || *cursor == 'p')) {
+        format = Format::DIMACS;
+    }
+}
+
+/**
+ * @brief Skips blanks and comments up to the next character to parse
+ * @param comment Character that starts a comment running to the end of the line
+ * @return bool False at end of input
+ */
+bool FormulaImporter::skipBlank(char comment) {
+    while (true) {
+        while (cursor < lineEnd && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' ||
+                                    *cursor == '\f' || *cursor == '\v')) {
+            ++cursor;
+        }
+        if (cursor < lineEnd && !(comment && *cursor == comment)) return true;
+        if (!reader.next(cursor, lineEnd)) return false;
+    }
+}
+
+/**
+ * @brief Builds an error for the current line
+ * @param message Description of the problem
+ * @return std::runtime_error The error to throw
+ */
+std::runtime_error FormulaImporter::error(const std::string& message) const {
+    return std::runtime_error("Line " + std::to_string(reader.getLine()) + ": " + message);
+}
+
+/**
+ * @brief Joins operands with one operator as a balanced tree
+ * @param op The binary operator
+ * @param operands DAG indices of the operands
+ * @param first Index of the first operand to join
+ * @param count Number of operands to join, at least one
+ * @return uint32_t DAG index of the balanced tree
+ */
+uint32_t FormulaImporter::combine(BatchEvaluator::Op op, const std::vector<uint32_t>& operands,
+                                  size_t first, size_t count) {
+    if (count == 1) return operands[first];
+
+    size_t half = count / 2;
+    uint32_t left = combine(op, operands, first, half);
+    uint32_t right = combine(op, operands, first + half, count - half);
+    return dag->addOperation(op, left, right);
+}
+
+/**
+ * @brief Reads the next formula into a DAG
+ * @param target The DAG receiving the formula as its next output
+ * @return bool False at end of input
+ * @throws std::runtime_error with the line number if the input is malformed
+ */
+bool FormulaImporter::next(BatchEvaluator& target) {
+    if (finished) return false;
+    dag = &target;
+
+    if (format == Format::DIMACS) {
+        // A DIMACS file is a single formula
+        finished = true;
+        dag->addOutput(readDimacs());
+        return true;
+    }
+
+    advance();
+    while (lookahead == TokenKind::SEMICOLON) advance();
+    if (lookahead == TokenKind::END) {
+        finished = true;
+        return false;
+    }
+
+    uint32_t formula = parseSentence();
+    if (lookahead == TokenKind::RIGHT_PAREN) {
+        throw error("Unmatched ')'");
+    }
+    if (lookahead != TokenKind::SEMICOLON && lookahead != TokenKind::END) {
+        throw error("Unexpected tokens after valid expression");
+    }
+    if (lookahead == TokenKind::END) finished = true;
+    dag->addOutput(formula);
+    return true;
+}
+
+/**
+ * @brief Reads the DIMACS "p cnf <variables> <clauses>" header from the current line
+ */
+void FormulaImporter::readHeader() {
+    ++cursor;   // 'p'
+    while (cursor < lineEnd && std::isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+    const char* word = cursor;
+    while (cursor < lineEnd && std::isalpha(static_cast<unsigned char>(*cursor))) ++cursor;
+    if (std::string(word, cursor) != "cnf") {
+        throw error("Expected 'p cnf <variables> <clauses>'");
+    }
+
+    size_t* counts[2] = {&declaredVariables, &declaredClauses};
+    for (size_t* count : counts) {
+        while (cursor < lineEnd && std::isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+        if (cursor == lineEnd || !std::isdigit(static_cast<unsigned char>(*cursor))) {
+            throw error("Expected 'p cnf <variables> <clauses>'");
+        }
+        *count = 0;
+        while (cursor < lineEnd && std::isdigit(static_cast<unsigned char>(*cursor))) {
+            size_t digit = *cursor++ - '0';
+            if (*count > (SIZE_MAX - digit) / 10) {
+                throw error("Count in 'p cnf' header is too large");
+            }
+            *count = *count * 10 + digit;
+        }
+    }
+    cursor = lineEnd;
+}
+
+/**
+ * @brief Names a DIMACS variable, zero-padded so names sort in numeric order
+ * @param variable The variable number, at most the declared count
+ * @return std::string The name, e.g. X07 when up to 99 variables are declared
+ */
+std::string FormulaImporter::dimacsName(size_t variable) const {
+    std::string digits = std::to_string(variable);
+    size_t width = std::to_string(declaredVariables).length();
+    return "X" + std::string(width - std::min(width, digits.length()), '0') + digits;
+}
+
+/**
+ * @brief Finds or adds the DAG node of a DIMACS literal
+ * @param variable The variable number, at least 1
+ * @param negative True for the negated literal
+ * @return uint32_t DAG index of the literal
+ */
+uint32_t FormulaImporter::dimacsLiteral(size_t variable, bool negative) {
+    using Op = BatchEvaluator::Op;
+    if (variable >= kMaxCachedVariable) {
+        uint32_t node = dag->addVariable(dimacsName(variable));
+        return negative ? dag->addOperation(Op::NOT, node) : node;
+    }
+
+    // Each literal is built once, so the common case is a single array lookup
+    size_t slot = 2 * variable + negative;
+    if (slot >= literalNodes.size()) {
+        literalNodes.resize(std::max(slot + 1, 2 * literalNodes.size()), kNoNode);
+    }
+    if (literalNodes[slot] == kNoNode) {
+        uint32_t node = dag->addVariable(dimacsName(variable));
+        literalNodes[slot] = negative ? dag->addOperation(Op::NOT, node) : node;
+    }
+    return literalNodes[slot];
+}
+
+/**
+ * @brief Reads a whole DIMACS CNF file
+ * @return uint32_t DAG index of the balanced conjunction of the clauses
+ */
+uint32_t FormulaImporter::readDimacs() {
+    using Op = BatchEvaluator::Op;
+    std::vector<uint32_t> clauseRoots;
+    std::vector<uint32_t> literals;
+    bool headerSeen = false;
+
+    // The header and comments are whole lines; literals are parsed straight out of
+    // the buffered line and may continue a clause from the previous line
+    while (skipBlank('\0')) {
+        char c = *cursor;
+        if (c == '%') break;    // Some benchmark files end with "%"
+        if (c == 'c') {
+            cursor = lineEnd;
+            continue;
+        }
+        if (c == 'p') {
+            if (headerSeen) throw error("Duplicate 'p cnf' header");
+            readHeader();
+            headerSeen = true;
+            continue;
+        }
+        if (!headerSeen) {
+            throw error("Clause before the 'p cnf' header");
+        }
+
+        bool negative = c == '-';
+        if (negative) ++cursor;
+        const char* digits = cursor;
+        size_t variable = 0;
+        while (cursor < lineEnd && static_cast<unsigned>(*cursor - '0') < 10) {
+            size_t digit = *cursor++ - '0';
+            if (variable > (SIZE_MAX - digit) / 10) {
+                throw error("Literal is too large");
+            }
+            variable = variable * 10 + digit;
+        }
+        if (cursor == digits || (cursor < lineEnd && !std::isspace(static_cast<unsigned char>(*cursor)))) {
+            throw error("Invalid literal in clause");
+        }
+
+        if (variable == 0) {
+            if (negative) throw error("Invalid literal '-0'");
+            // An empty clause can never be satisfied
+            clauseRoots.push_back(literals.empty() ? dag->addConstant(false)
+                                                   : combine(Op::OR, literals, 0, literals.size()));
+            literals.clear();
+            continue;
+        }
+        if (variable > declaredVariables) {
+            throw error("Variable " + std::to_string(variable) + " exceeds the declared " +
+                        std::to_string(declaredVariables));
+        }
+
+        // Named from the value, so "01" and "1" are the same variable
+        literals.push_back(dimacsLiteral(variable, negative));
+    }
+
+    // The final clause may omit its terminating 0
+    if (!literals.empty()) {
+        clauseRoots.push_back(combine(Op::OR, literals, 0, literals.size()));
+        literals.clear();
+    }
+
+    if (!headerSeen) {
+        throw error("Missing 'p cnf' header");
+    }
+    clauses = clauseRoots.size();
+    // A count that disagrees with the header usually means a truncated file
+    if (clauses != declaredClauses) {
+        throw error("Read " + std::to_string(clauses) + " clause(s), but the 'p cnf' header declares " +
+                    std::to_string(declaredClauses));
+    }
+    if (clauseRoots.empty()) {
+        return dag->addConstant(true);
+    }
+    return combine(Op::AND, clauseRoots, 0, clauseRoots.size());
+}
+
+/**
+ * @brief Reads the next infix token into lookahead and lexeme
+ */
+void FormulaImporter::advance() {
+    if (!skipBlank('#')) {
+        lookahead = TokenKind::END;
+        return;
+    }
+
+    char c = *cursor++;
+    switch (c) {
+        case ';': lookahead = TokenKind::SEMICOLON; return;
+        case '(': lookahead = TokenKind::LEFT_PAREN; return;
+        case ')': lookahead = TokenKind::RIGHT_PAREN; return;
+        default: break;
+    }
+    if (!std::isalpha(static_cast<unsigned char>(c))) {
+        throw error("Invalid character: '" + std::string(1, c) + "'");
+    }
+
+    const char* start = cursor - 1;
+    while (cursor < lineEnd && std::isalnum(static_cast<unsigned char>(*cursor))) ++cursor;
+    lexeme.assign(start, cursor);
+
+    if (lexeme == "TRUE") lookahead = TokenKind::TRUE;
+    else if (lexeme == "FALSE") lookahead = TokenKind::FALSE;
+    else if (lexeme == "NOT") lookahead = TokenKind::NOT;
+    else if (lexeme == "AND") lookahead = TokenKind::AND;
+    else if (lexeme == "OR") lookahead = TokenKind::OR;
+    else if (lexeme == "IMPLIES") lookahead = TokenKind::IMPLIES;
+    else if (lexeme == "EQUIVALENT") lookahead = TokenKind::EQUIVALENT;
+    else {
+        bool variable = std::isupper(static_cast<unsigned char>(lexeme[0]));
+        for (size_t i = 1; i < lexeme.length(); ++i) {
+            variable = variable && std::isdigit(static_cast<unsigned char>(lexeme[i]));
+        }
+        if (!variable) {
+            throw error("Invalid token: '" + lexeme + "'");
+        }
+        lookahead = TokenKind::VARIABLE;
+    }
+}
+
+/**
+ * @brief Parses a sequence of terms joined by binary operators
+ * @return uint32_t DAG index of the parsed subformula
+ */
+uint32_t FormulaImporter::parseSentence() {
+    using Op = BatchEvaluator::Op;
+    auto operation = [](TokenKind op) {
+        switch (op) {
+            case TokenKind::AND: return Op::AND;
+            case TokenKind::OR: return Op::OR;
+            case TokenKind::IMPLIES: return Op::IMPLIES;
+            default: return Op::EQUIVALENT;
+        }
+    };
+
+    // Operators share one precedence and group to the left, as in Parser. A run
+    // of one associative operator is collected and joined as a balanced tree.
+    std::vector<uint32_t> run{parseTerm()};
+    TokenKind runOperator = TokenKind::END;
+
+    while (true) {
+        TokenKind op = lookahead;
+        if (op != TokenKind::AND && op != TokenKind::OR &&
+            op != TokenKind::IMPLIES && op != TokenKind::EQUIVALENT) {
+            break;
+        }
+        std::string name = lexeme;
+        advance();
+        if (lookahead == TokenKind::END || lookahead == TokenKind::SEMICOLON ||
+            lookahead == TokenKind::RIGHT_PAREN) {
+            throw error("Missing right operand after '" + name + "'");
+        }
+        uint32_t right = parseTerm();
+
+        if (op == runOperator && op != TokenKind::IMPLIES) {
+            run.push_back(right);
+            continue;
+        }
+
+        uint32_t left = combine(operation(runOperator), run, 0, run.size());
+        if (op == TokenKind::IMPLIES) {
+            // IMPLIES is not associative, so it is joined immediately
+            run.assign(1, dag->addOperation(Op::IMPLIES, left, right));
+            runOperator = TokenKind::END;
+        } else {
+            run.assign({left, right});
+            runOperator = op;
+        }
+    }
+
+    return combine(operation(runOperator), run, 0, run.size());
+}
+
+/**
+ * @brief Parses a variable, constant, negation or parenthesized sentence
+ * @return uint32_t DAG index of the parsed subformula
+ */
+uint32_t FormulaImporter::parseTerm() {
+    // Count leading NOTs instead of recursing, so long chains do not deepen the stack
+    size_t negations = 0;
+    while (lookahead == TokenKind::NOT) {
+        ++negations;
+        advance();
+    }
+
+    uint32_t term;
+    switch (lookahead) {
+        case TokenKind::VARIABLE:
+            term = dag->addVariable(lexeme);
+            advance();
+            break;
+
+        case TokenKind::TRUE:
+        case TokenKind::FALSE:
+            term = dag->addConstant(lookahead == TokenKind::TRUE);
+            advance();
+            break;
+
+        case TokenKind::LEFT_PAREN:
+            advance();
+            if (lookahead == TokenKind::RIGHT_PAREN) {
+                throw error("Empty parentheses");
+            }
+            term = parseSentence();
+            if (lookahead != TokenKind::RIGHT_PAREN) {
+                throw error("Missing closing parenthesis");
+            }
+            advance();
+            break;
+
+        case TokenKind::END:
+        case TokenKind::SEMICOLON:
+            throw error(negations ? "Missing operand after NOT" : "Unexpected end of formula");
+
+        case TokenKind::RIGHT_PAREN:
+            throw error("Unexpected ')'");
+
+        default:
+            throw error("Binary operator '" + lexeme + "' must have both left and right operands");
+    }
+
+    // Double negations cancel in the DAG, so only the parity of the count matters
+    if (negations % 2) {
+        term = dag->addOperation(BatchEvaluator::Op::NOT, term);
+    }
+    return term;
+}
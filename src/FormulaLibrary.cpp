@@ -0,0 +1,191 @@
+#include <cstring>
+#include <fstream>
+#include "../include/FormulaLibrary.h"
+
+static const char kMagic[8] = {'L', 'O', 'G', 'I', 'C', 'L', 'I', 'B'};
+static const uint32_t kByteOrder = 0x01020304;
+
+static_assert(sizeof(BatchEvaluator::DagNode) == 12, "DagNode layout is part of the library format");
+
+/**
+ * @brief Computes the byte offset of the string offset table
+ * @param nodeCount Number of DAG nodes
+ * @param formulaCount Number of formulas
+ * @return size_t Offset from the start of the file
+ */
+size_t FormulaLibrary::offsetsPosition(size_t nodeCount, size_t formulaCount) {
+    size_t position = sizeof(Header) + nodeCount * sizeof(BatchEvaluator::DagNode) +
+                      formulaCount * sizeof(uint32_t);
+    return (position + 7) / 8 * 8;
+}
+
+/**
+ * @brief Writes the compiled DAG of a batch to a library file
+ * @param batch The compiled formulas
+ * @param path Path of the library file to create
+ * @throws std::runtime_error if the file cannot be written
+ */
+void FormulaLibrary::write(const BatchEvaluator& batch, const std::string& path) {
+    std::vector<std::string> strings = batch.getVariables();
+    strings.insert(strings.end(), batch.getLabels().begin(), batch.getLabels().end());
+
+    std::vector<uint64_t> offsets{0};
+    for (const auto& text : strings) {
+        offsets.push_back(offsets.back() + text.size());
+    }
+    if (offsets.back() > UINT32_MAX) {
+        throw std::runtime_error("Formula labels are too large for a library file");
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrder;
+    header.variableCount = static_cast<uint32_t>(batch.getVariables().size());
+    header.nodeCount = static_cast<uint32_t>(batch.getNodes().size());
+    header.formulaCount = static_cast<uint32_t>(batch.getOutputs().size());
+    header.stringBytes = static_cast<uint32_t>(offsets.back());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open library file: " + path);
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(batch.getNodes().data()),
+              batch.getNodes().size() * sizeof(BatchEvaluator::DagNode));
+    out.write(reinterpret_cast<const char*>(batch.getOutputs().data()),
+              batch.getOutputs().size() * sizeof(uint32_t));
+
+    size_t written = sizeof(header) + batch.getNodes().size() * sizeof(BatchEvaluator::DagNode) +
+                     batch.getOutputs().size() * sizeof(uint32_t);
+    static const char zeros[8] = {};
+    out.write(zeros, offsetsPosition(header.nodeCount, header.formulaCount) - written);
+
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    for (const auto& text : strings) {
+        out.write(text.data(), text.size());
+    }
+
+    if (!out.flush()) {
+        throw std::runtime_error("Could not write library file: " + path);
+    }
+}
+
+/**
+ * @brief Loads a library file for in-place evaluation
+ * @param path Path of the library file
+ * @throws std::runtime_error if the file is missing, from another version or corrupt
+ */
+FormulaLibrary::FormulaLibrary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not open library file: " + path);
+    }
+
+    // One read of the whole file; the arrays are then used where they lie
+    size_t size = static_cast<size_t>(in.tellg());
+    buffer.resize((size + 7) / 8);
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer.data()), size);
+    if (!in || size < sizeof(Header)) {
+        throw std::runtime_error("Library file is truncated: " + path);
+    }
+
+    const Header& head = header();
+    if (std::memcmp(head.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a formula library: " + path);
+    }
+    if (head.version != kVersion) {
+        throw std::runtime_error("Unsupported library version " + std::to_string(head.version) +
+                                 " in " + path + "; recompile it");
+    }
+    if (head.byteOrder != kByteOrder) {
+        throw std::runtime_error("Library was compiled on a machine with a different byte order: " + path);
+    }
+
+    size_t stringCount = size_t(head.variableCount) + head.formulaCount;
+    size_t expected = offsetsPosition(head.nodeCount, head.formulaCount) +
+                      (stringCount + 1) * sizeof(uint64_t) + head.stringBytes;
+    if (size != expected) {
+        throw std::runtime_error("Library file has the wrong size: " + path);
+    }
+
+    // Operands must precede their users so evaluation can run front to back
+    const BatchEvaluator::DagNode* dag = nodes();
+    for (uint32_t i = 0; i < head.nodeCount; ++i) {
+        using Op = BatchEvaluator::Op;
+        bool valid;
+        switch (dag[i].op) {
+            case Op::FALSE_CONST: case Op::TRUE_CONST: valid = true; break;
+            case Op::VARIABLE: valid = dag[i].left < head.variableCount; break;
+            case Op::NOT: valid = dag[i].left < i; break;
+            case Op::AND: case Op::OR: case Op::IMPLIES: case Op::EQUIVALENT:
+                valid = dag[i].left < i && dag[i].right < i;
+                break;
+            default: valid = false; break;
+        }
+        if (!valid) {
+            throw std::runtime_error("Library file has an invalid node " + std::to_string(i) + ": " + path);
+        }
+    }
+    for (uint32_t f = 0; f < head.formulaCount; ++f) {
+        if (outputs()[f] >= head.nodeCount) {
+            throw std::runtime_error("Library file has an invalid formula " + std::to_string(f) + ": " + path);
+        }
+    }
+    const uint64_t* offsets = stringOffsets();
+    for (size_t i = 0; i < stringCount; ++i) {
+        if (offsets[i] > offsets[i + 1]) {
+            throw std::runtime_error("Library file has an invalid string table: " + path);
+        }
+    }
+    if (offsets[0] != 0 || offsets[stringCount] != head.stringBytes) {
+        throw std::runtime_error("Library file has an invalid string table: " + path);
+    }
+}
+
+/**
+ * @brief Evaluates every formula of the library in one pass
+ * @return Columns for the variables followed by one result column per formula
+ */
+TruthColumns FormulaLibrary::evaluate() const {
+    const Header& head = header();
+    TruthColumns table = BatchEvaluator::evaluateDag(nodes(), head.nodeCount, outputs(),
+                                                     head.formulaCount, head.variableCount);
+    for (size_t i = 0; i < size_t(head.variableCount) + head.formulaCount; ++i) {
+        table.labels.push_back(stringAt(i));
+    }
+    return table;
+}
+
+const BatchEvaluator::DagNode* FormulaLibrary::nodes() const {
+    return reinterpret_cast<const BatchEvaluator::DagNode*>(
+        reinterpret_cast<const char*>(buffer.data()) + sizeof(Header));
+}
+
+const uint32_t* FormulaLibrary::outputs() const {
+    return reinterpret_cast<const uint32_t*>(
+        reinterpret_cast<const char*>(nodes()) + header().nodeCount * sizeof(BatchEvaluator::DagNode));
+}
+
+const uint64_t* FormulaLibrary::stringOffsets() const {
+    return reinterpret_cast<const uint64_t*>(
+        reinterpret_cast<const char*>(buffer.data()) +
+        offsetsPosition(header().nodeCount, header().formulaCount));
+}
+
+const char* FormulaLibrary::strings() const {
+    return reinterpret_cast<const char*>(
+        stringOffsets() + header().variableCount + header().formulaCount + 1);
+}
+
+/**
+ * @brief Retrieves one string of the string table
+ * @param index Variables first, then formula labels
+ * @return std::string A copy of the string
+ */
+std::string FormulaLibrary::stringAt(size_t index) const {
+    const uint64_t* offsets = stringOffsets();
+    return std::string(strings() + offsets[index], offsets[index + 1] - offsets[index]);
+}
@@ -0,0 +1,47 @@
+#include <cstring>
+#include "../include/LineReader.h"
+
+// Bytes requested from the stream whenever the buffer runs out of complete lines
+static const size_t kReadChunkSize = 1 << 20;
+
+/**
+ * @brief Constructs a reader for a stream
+ * @param input The stream to read lines from
+ */
+LineReader::LineReader(std::istream& input) : input(input), position(0), line(0) {
+}
+
+/**
+ * @brief Retrieves the next line without its newline
+ * @param begin Set to the first character of the line
+ * @param end Set one past the last character of the line
+ * @return bool False at end of input
+ */
+bool LineReader::next(const char*& begin, const char*& end) {
+    while (true) {
+        const char* start = buffer.data() + position;
+        const char* stop = buffer.data() + buffer.size();
+        const char* newline = start < stop
+            ? static_cast<const char*>(std::memchr(start, '\n', stop - start))
+            : nullptr;
+
+        // Refill when no complete line is buffered, unless the stream is exhausted
+        if (!newline && input) {
+            buffer.erase(buffer.begin(), buffer.begin() + position);
+            position = 0;
+            size_t used = buffer.size();
+            buffer.resize(used + kReadChunkSize);
+            input.read(buffer.data() + used, kReadChunkSize);
+            buffer.resize(used + static_cast<size_t>(input.gcount()));
+            continue;
+        }
+
+        if (start == stop) return false;
+
+        begin = start;
+        end = newline ? newline : stop;
+        position = (newline ? newline + 1 : stop) - buffer.data();
+        ++line;
+        return true;
+    }
+}
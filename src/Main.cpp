@@ -3,9 +3,201 @@
 #include "../include/Evaluator.h"
 #include "../include/Parser.h"
 #include "../include/Evaluator.h"
+#include "../include/Minimizer.h"
+#include "../include/AssignmentReader.h"
+#include "../include/ChunkedTable.h"
+#include "../include/BatchEvaluator.h"
+#include "../include/Shard.h"
+#include "../include/OutputWriter.h"
+#include "../include/FormulaLibrary.h"
+#include "../include/Sampler.h"
+#include "../include/MemoryStats.h"
+#include "../include/Checker.h"
+#include "../include/FormulaImporter.h"
 #include <fstream>
+#include <sstream>
+#include <memory>
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
 #include <iomanip>
+#include <random>
 
+// Rows evaluated per block in bulk mode
+static const size_t kBulkBlockRows = 64 * 1024;
+
+// Command-line options shared by the file and interactive modes
+struct Options {
+    bool minimize = false;      // Print minimal SOP/POS forms instead of the truth table
+    bool batch = false;         // Evaluate every formula of inputFile in one shared pass
+    bool bulk = false;          // Evaluate bulkFormula over assignments read from inputFile or stdin
+    std::string bulkFormula;
+    std::vector<std::string> columns;       // Only compute these truth table columns when non-empty
+    std::string spillDirectory;             // Write chunked tables under this directory instead of printing
+    size_t maxMemory = size_t(256) << 20;   // Column budget per chunk in spill mode
+    size_t shardIndex = 0;      // With shardCount > 0, evaluate only this slice of the rows
+    size_t shardCount = 0;
+    size_t workers = 0;         // Run this many shard worker processes and merge their output
+    std::string outputPath;     // Shard file (--shard) or shard directory (--workers)
+    bool merge = false;         // "merge" subcommand: combine the shard files in mergeFiles
+    bool countOnly = false;     // Print only the number of true rows
+    std::vector<std::string> mergeFiles;
+    bool compile = false;       // "compile" subcommand: write the formulas of inputFile to libraryPath
+    std::string libraryPath;    // Library file to write (compile) or to evaluate (--library)
+    size_t sampleCount = 0;     // Estimate each formula from this many random rows instead of enumerating
+    uint64_t seed = 0;          // Random seed for --sample
+    bool seedGiven = false;
+    bool import = false;        // Stream inputFile as DIMACS CNF or multi-line infix formulas
+    std::string check;          // "valid", "sat" or "unsat": search for one deciding row only
+    bool memReport = false;     // Print per-stage memory use after each formula
+    bool memReportCsv = false;  // Write the memory report as CSV lines to stderr instead
+    std::string inputFile;      // Empty for interactive mode
+};
+
+static Options parse_arguments(int argc, char* argv[]) {
+    Options options;
+    int first = 1;
+    if (argc > 1 && std::string(argv[1]) == "merge") {
+        options.merge = true;
+        first = 2;
+    } else if (argc > 1 && std::string(argv[1]) == "compile") {
+        options.compile = true;
+        first = 2;
+    }
+
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--minimize") {
+            options.minimize = true;
+        } else if (arg == "--batch") {
+            options.batch = true;
+        } else if (arg == "--bulk") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--bulk requires a formula");
+            }
+            options.bulk = true;
+            options.bulkFormula = argv[++i];
+        } else if (arg == "--columns") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--columns requires a comma-separated list of columns");
+            }
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.length()) {
+                size_t comma = std::min(list.find(',', start), list.length());
+                options.columns.push_back(list.substr(start, comma - start));
+                start = comma + 1;
+            }
+        } else if (arg == "--spill" || arg == "--max-memory") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(arg + " requires a value");
+            }
+            std::string value = argv[++i];
+            if (arg == "--spill") options.spillDirectory = value;
+            else options.maxMemory = parseMemorySize(value);
+        } else if (arg == "--shard") {
+            std::string value = i + 1 < argc ? argv[++i] : "";
+            size_t slash = value.find('/');
+            try {
+                if (slash == std::string::npos) throw std::invalid_argument(value);
+                options.shardIndex = std::stoull(value.substr(0, slash));
+                options.shardCount = std::stoull(value.substr(slash + 1));
+            } catch (const std::logic_error&) {
+                throw std::runtime_error("--shard expects k/N, got '" + value + "'");
+            }
+            if (options.shardIndex >= options.shardCount) {
+                throw std::runtime_error("--shard index must be below the shard count");
+            }
+        } else if (arg == "--workers") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--workers requires a count");
+            }
+            options.workers = std::strtoul(argv[++i], nullptr, 10);
+            if (options.workers == 0) {
+                throw std::runtime_error("--workers must be at least 1");
+            }
+        } else if (arg == "--output") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--output requires a path");
+            }
+            options.outputPath = argv[++i];
+        } else if (arg == "--library") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--library requires a library file");
+            }
+            options.libraryPath = argv[++i];
+        } else if (arg == "--sample" || arg == "--seed") {
+            std::string value = i + 1 < argc ? argv[++i] : "";
+            char* end = nullptr;
+            unsigned long long number = std::strtoull(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0') {
+                throw std::runtime_error(arg + " expects a non-negative integer, got '" + value + "'");
+            }
+            if (arg == "--sample") {
+                options.sampleCount = number;
+                if (number == 0) {
+                    throw std::runtime_error("--sample must be at least 1");
+                }
+            } else {
+                options.seed = number;
+                options.seedGiven = true;
+            }
+        } else if (arg == "--import") {
+            options.import = true;
+        } else if (arg == "--check") {
+            options.check = i + 1 < argc ? argv[++i] : "";
+            if (options.check != "valid" && options.check != "sat" && options.check != "unsat") {
+                throw std::runtime_error("--check expects valid, sat or unsat, got '" + options.check + "'");
+            }
+        } else if (arg == "--mem-report") {
+            options.memReport = true;
+        } else if (arg == "--mem-report-csv") {
+            options.memReport = true;
+            options.memReportCsv = true;
+        } else if (arg == "--count") {
+            options.countOnly = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::runtime_error("Unknown option: " + arg);
+        } else if (options.merge) {
+            options.mergeFiles.push_back(arg);
+        } else if (options.inputFile.empty()) {
+            options.inputFile = arg;
+        } else if (options.compile && options.libraryPath.empty()) {
+            options.libraryPath = arg;
+        } else {
+            throw std::runtime_error("Only one input file may be given");
+        }
+    }
+
+    if (options.merge && options.mergeFiles.empty()) {
+        throw std::runtime_error("merge requires at least one shard file");
+    }
+    if (options.compile && options.libraryPath.empty()) {
+        throw std::runtime_error("compile requires an input file and a library file");
+    }
+    if (options.shardCount > 0 && (options.inputFile.empty() || options.outputPath.empty())) {
+        throw std::runtime_error("--shard requires an input file and --output <file>");
+    }
+    if (options.import && (options.bulk || options.merge || (!options.compile && !options.libraryPath.empty()))) {
+        // These read assignments, shard files or a library rather than formulas
+        throw std::runtime_error("--import cannot be combined with --bulk, --library or merge");
+    }
+    if (options.import && options.inputFile.empty()) {
+        throw std::runtime_error("--import requires an input file");
+    }
+    if (options.workers > 0 && options.inputFile.empty()) {
+        throw std::runtime_error("--workers requires an input file");
+    }
+    if (!options.seedGiven) {
+        // Printed with the results, so any run can be repeated with --seed
+        options.seed = std::random_device{}();
+    }
+    return options;
+}
 
 static std::vector<std::string> read_input_file(const std::string& filename) {
     std::vector<std::string> lines;
@@ -27,79 +219,788 @@ static std::vector<std::string> read_input_file(const std::string& filename) {
     return lines;
 }
 
+// Evaluate one expression over every row of a CSV assignment source, one result per line
+static void process_bulk(const std::string& input_string, std::istream& assignments) {
+    Scanner scanner(input_string);
+    std::vector<Token> tokens = scanner.getTokens();
+    Parser parser(tokens);
+    std::unique_ptr<Node> parse_tree(parser.parseSentence());
+
+    // Compile once; each block is then a pass over the flat DAG
+    BatchEvaluator compiled({parse_tree.get()});
+    AssignmentReader reader(assignments);
+
+    // Assignment column of each DAG variable, resolved once
+    std::vector<size_t> columnOf;
+    const std::vector<std::string>& names = reader.getVariables();
+    for (const auto& var : compiled.getVariables()) {
+        auto it = std::find(names.begin(), names.end(), var);
+        if (it == names.end()) {
+            throw std::runtime_error("Missing assignment column for variable: " + var);
+        }
+        columnOf.push_back(it - names.begin());
+    }
+
+    std::cout.flush();
+    OutputWriter writer(stdout);
+
+    std::vector<std::vector<uint64_t>> columns;
+    std::vector<const uint64_t*> inputs(columnOf.size());
+    std::vector<uint64_t> scratch;
+    std::string output;
+    size_t rows;
+    while ((rows = reader.readBlock(columns, kBulkBlockRows)) > 0) {
+        for (size_t j = 0; j < columnOf.size(); ++j) {
+            inputs[j] = columns[columnOf[j]].data();
+        }
+        std::vector<uint64_t> result = compiled.evaluateColumns(0, inputs, rows, scratch);
+
+        output.resize(rows * 2);
+        for (size_t row = 0; row < rows; ++row) {
+            output[row * 2] = ((result[row / 64] >> (row % 64)) & 1) ? '1' : '0';
+            output[row * 2 + 1] = '\n';
+        }
+        writer.write(output);
+    }
+    writer.flush();
+}
+
+// Print the minimal two-level forms of an expression
+static void print_minimized(const std::vector<std::string>& variables,
+                            const std::vector<uint64_t>& column) {
+    // Forms that are not proven minimal are labelled as such
+    Minimizer minimizer(variables, column);
+    bool exact;
+    std::string sop = minimizer.minimalSOP(exact);
+    std::cout << (exact ? "Minimal SOP: " : "Near-minimal SOP: ") << sop << "\n";
+    std::string pos = minimizer.minimalPOS(exact);
+    std::cout << (exact ? "Minimal POS: " : "Near-minimal POS: ") << pos << "\n";
+}
+
+// Print a truth table with one aligned column per label
+static void print_truth_table(const TruthColumns& table) {
+    std::cout << "Truth Table:\n";
+    std::cout.flush();
+
+    // Rows are formatted on this thread and written by the writer thread, so a slow
+    // pipe or disk does not stall formatting
+    OutputWriter writer(stdout);
+
+    // Calculate column widths
+    std::vector<size_t> columnWidths;
+    for (const auto& col : table.labels) {
+        columnWidths.push_back(std::max(col.length(), size_t(5)) + 2); // minimum width of 5 plus padding
+    }
+
+    // Print header with proper alignment
+    std::string line;
+    for (size_t i = 0; i < table.labels.size(); ++i) {
+        line += table.labels[i];
+        line.append(columnWidths[i] - table.labels[i].length(), ' ');
+        line += '|';
+    }
+    line += '\n';
+
+    // Print separator line
+    for (const auto& width : columnWidths) {
+        line.append(width, '-');
+        line += '+';
+    }
+    line += '\n';
+    writer.write(line);
+
+    // Print rows with proper alignment
+    for (size_t row = 0; row < table.numRows; ++row) {
+        line.clear();
+        for (size_t i = 0; i < table.labels.size(); ++i) {
+            line += table.get(i, row) ? 'T' : 'F';
+            line.append(columnWidths[i] - 1, ' ');
+            line += '|';
+        }
+        line += '\n';
+        writer.write(line);
+    }
+
+    writer.flush();
+}
+
+// Parse every formula of a file; bad lines are reported, counted in failed and left out
+static std::vector<std::unique_ptr<Node>> parse_formulas(const std::vector<std::string>& inputs,
+                                                         size_t& failed) {
+    std::vector<std::unique_ptr<Node>> trees;
+    failed = 0;
+    for (const auto& input_string : inputs) {
+        try {
+            Scanner scanner(input_string);
+            std::vector<Token> tokens = scanner.getTokens();
+            Parser parser(tokens);
+            trees.emplace_back(parser.parseSentence());
+        } catch (const std::exception& e) {
+            std::cout << "Error in '" << input_string << "': " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+    return trees;
+}
+
+static std::vector<Node*> tree_roots(const std::vector<std::unique_ptr<Node>>& trees) {
+    std::vector<Node*> roots;
+    for (const auto& tree : trees) {
+        roots.push_back(tree.get());
+    }
+    return roots;
+}
+
+// Print the per-stage memory use of one formula, as a table or as CSV lines on stderr
+static void print_memory_report(const std::string& formula, const MemoryMeter& meter, bool csv) {
+    bool counting = memoryCountingEnabled();
+    // The OS only reports the process's high-water mark, so it is shown once, not per stage
+    uint64_t peakResident = peakResidentBytes();
+    if (csv) {
+        static bool headerPrinted = false;
+        if (!headerPrinted) {
+            std::cerr << "formula,stage,allocations,bytes,peak_live_bytes,process_peak_rss_bytes\n";
+            headerPrinted = true;
+        }
+
+        std::string quoted = "\"";
+        for (char c : formula) {
+            if (c == '"') quoted += '"';
+            quoted += c;
+        }
+        quoted += '"';
+
+        // Fields that were not measured are left empty
+        for (const auto& usage : meter.getStages()) {
+            std::cerr << quoted << ',' << usage.stage << ',';
+            if (counting) {
+                std::cerr << usage.allocations << ',' << usage.bytes << ',' << usage.peakBytes;
+            } else {
+                std::cerr << ",,";
+            }
+            std::cerr << ',';
+            if (peakResident > 0) std::cerr << peakResident;
+            std::cerr << '\n';
+        }
+        std::cerr.flush();
+        return;
+    }
+
+    auto field = [](bool available, uint64_t value) {
+        std::string text = available ? std::to_string(value) : "n/a";
+        return text + std::string(text.length() < 16 ? 16 - text.length() : 1, ' ');
+    };
+
+    std::cout << "Memory:\n";
+    std::cout << "Stage     Allocations     Bytes           Peak live bytes\n";
+    for (const auto& usage : meter.getStages()) {
+        std::cout << usage.stage << std::string(10 - usage.stage.length(), ' ')
+                  << field(counting, usage.allocations) << field(counting, usage.bytes)
+                  << field(counting, usage.peakBytes) << "\n";
+    }
+    if (peakResident > 0) {
+        std::cout << "Process peak RSS since start-up: " << peakResident << " bytes\n";
+    }
+    if (!counting) {
+        std::cout << "(Allocation counts need a build with -DLOGIC_MEM_STATS)\n";
+    }
+    std::cout.flush();
+}
+
+// Answer a validity or satisfiability question, printing only the deciding assignment
+static void print_check(Checker& checker, const std::string& question) {
+    const std::vector<std::string>& variables = checker.getVariables();
+
+    // Validity is refuted by a false row; satisfiability (and unsatisfiability) by a true one
+    bool lookFor = question != "valid";
+    size_t row;
+    bool found = checker.findRow(lookFor, row);
+
+    if (question == "valid") {
+        std::cout << (found ? "Not valid. Counterexample:" : "Valid");
+    } else if (question == "sat") {
+        std::cout << (found ? "Satisfiable. Witness:" : "Unsatisfiable");
+    } else {
+        std::cout << (found ? "Not unsatisfiable. Witness:" : "Unsatisfiable");
+    }
+    if (found) {
+        for (size_t j = 0; j < variables.size(); ++j) {
+            std::cout << ' ' << variables[j] << '=' << (((row >> j) & 1) ? 'T' : 'F');
+        }
+    }
+    std::cout << std::endl;
+}
+
+// Print a sampled estimate of the satisfying fraction with one example row of each kind
+static void print_sample(Sampler& sampler, const Options& options) {
+    SampleResult result = sampler.run(options.sampleCount);
+    const std::vector<std::string>& variables = sampler.getVariables();
+
+    auto print_row = [&variables](const char* title, bool found, const std::vector<bool>& row) {
+        std::cout << title;
+        if (!found) {
+            std::cout << " none sampled" << std::endl;
+            return;
+        }
+        for (size_t j = 0; j < variables.size(); ++j) {
+            std::cout << ' ' << variables[j] << '=' << (row[j] ? 'T' : 'F');
+        }
+        std::cout << std::endl;
+    };
+
+    std::cout << "Samples: " << result.samples << " (" << variables.size()
+              << " variable(s), seed " << options.seed << ")" << std::endl;
+    std::cout << "True rows: " << result.trueCount << std::endl;
+    std::cout << std::fixed << std::setprecision(6)
+              << "Estimated satisfying fraction: " << double(result.trueCount) / result.samples
+              << " (95% CI " << result.low << " - " << result.high << ")" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    print_row("Example satisfying row:", result.foundSatisfying, result.satisfyingRow);
+    print_row("Example falsifying row:", result.foundFalsifying, result.falsifyingRow);
+}
+
+// Evaluate all formulas of a file over their combined variables in a single pass
+static void process_batch(const std::vector<std::string>& inputs, const Options& options) {
+    // Scanning and parsing of the whole file is measured together under "parse"
+    MemoryMeter meter;
+    meter.start("parse");
+    size_t failed;
+    std::vector<std::unique_ptr<Node>> trees = parse_formulas(inputs, failed);
+
+    meter.start("evaluate");
+    BatchEvaluator batch(tree_roots(trees));
+    std::cout << "\nProcessing batch: " << trees.size() << " formula(s), "
+              << batch.distinctNodes() << " distinct node(s)" << std::endl;
+    TruthColumns table = batch.evaluate();
+
+    meter.start("print");
+    print_truth_table(table);
+    meter.stop();
+
+    if (options.memReport) {
+        print_memory_report("batch of " + std::to_string(trees.size()) + " formula(s)", meter,
+                            options.memReportCsv);
+    }
+
+    // The other formulas are still shown, but the run must not look complete
+    if (failed > 0) {
+        throw std::runtime_error(std::to_string(failed) + " formula(s) could not be parsed");
+    }
+}
+
+// Compile all formulas of a file into a binary library for later --library runs
+static void process_compile(const std::vector<std::string>& inputs, const std::string& libraryPath) {
+    size_t failed;
+    std::vector<std::unique_ptr<Node>> trees = parse_formulas(inputs, failed);
+    // Formulas are looked up by position, so a library missing one would shift all later ones
+    if (failed > 0) {
+        throw std::runtime_error("No library written: " + std::to_string(failed) +
+                                 " formula(s) could not be parsed");
+    }
+    BatchEvaluator batch(tree_roots(trees));
+    FormulaLibrary::write(batch, libraryPath);
+    std::cout << "Compiled " << trees.size() << " formula(s) (" << batch.distinctNodes()
+              << " node(s)) to " << libraryPath << std::endl;
+}
+
+// Evaluate a compiled library without scanning or parsing any formula text
+static void process_library(const std::string& libraryPath) {
+    FormulaLibrary library(libraryPath);
+    std::cout << "\nProcessing library: " << library.formulaCount() << " formula(s), "
+              << library.nodeCount() << " distinct node(s)" << std::endl;
+    print_truth_table(library.evaluate());
+}
+
+// Open the shard file of a --shard run, replacing any earlier one
+static std::ofstream open_shard_output(const Options& options) {
+    std::ofstream out(options.outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open shard output: " + options.outputPath);
+    }
+    return out;
+}
+
+// Finish a shard file; a shard with missing sections must not look complete
+static void close_shard_output(std::ofstream& out, const Options& options, size_t failed) {
+    if (!out.flush()) {
+        throw std::runtime_error("Could not write shard output: " + options.outputPath);
+    }
+    if (failed > 0) {
+        throw std::runtime_error(std::to_string(failed) + " formula(s) could not be evaluated");
+    }
+}
+
+// Evaluate this process's shard of every formula and write the sections to one shard file
+static void process_shard(const std::vector<std::string>& inputs, const Options& options) {
+    std::ofstream out = open_shard_output(options);
+
+    // Every formula is attempted, but a shard with missing sections must not look complete
+    size_t failed = 0;
+    for (size_t position = 0; position < inputs.size(); ++position) {
+        const std::string& input_string = inputs[position];
+        try {
+            Scanner scanner(input_string);
+            std::vector<Token> tokens = scanner.getTokens();
+            Parser parser(tokens);
+            std::unique_ptr<Node> parse_tree(parser.parseSentence());
+
+            BatchEvaluator compiled({parse_tree.get()});
+            writeShard(out, computeShard(compiled, 0, position, options.shardIndex, options.shardCount));
+        } catch (const std::exception& e) {
+            std::cout << "Error in '" << input_string << "': " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+    close_shard_output(out, options, failed);
+}
+
+// Merge shard files and print each formula's full table, or only its true-row count
+static void process_merge(const std::vector<std::string>& files, bool countOnly) {
+    std::vector<ShardSection> sections;
+    for (const auto& file : files) {
+        auto fileSections = readShards(file, !countOnly);
+        sections.insert(sections.end(), fileSections.begin(), fileSections.end());
+    }
+
+    for (const auto& merged : mergeShards(sections)) {
+        std::cout << "\nProcessing: " << merged.formula << std::endl;
+        if (countOnly) {
+            std::cout << "True rows: " << merged.trueCount << " of " << merged.rows << std::endl;
+            continue;
+        }
+
+        TruthColumns table;
+        table.numRows = merged.rows;
+        table.labels = merged.variables;
+        table.labels.push_back(merged.formula);
+        for (size_t j = 0; j < merged.variables.size(); ++j) {
+            std::vector<uint64_t> column(merged.numWords);
+            for (size_t word = 0; word < merged.numWords; ++word) {
+                column[word] = variableWord(j, word) & rowMask(merged.rows, word);
+            }
+            table.columns.push_back(std::move(column));
+        }
+        table.columns.push_back(merged.words);
+        print_truth_table(table);
+    }
+}
+
+// Quote a command-line argument for std::system
+static std::string quote_argument(const std::string& arg) {
+    std::string quoted = "\"";
+    for (char c : arg) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Act as a local coordinator: run one shard worker process per slice, then merge
+static void process_workers(const std::string& program, const Options& options) {
+    namespace fs = std::filesystem;
+    bool temporary = options.outputPath.empty();
+    fs::path directory = temporary
+        ? fs::temp_directory_path() /
+              ("logic_shards_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))
+        : fs::path(options.outputPath);
+    fs::create_directories(directory);
+
+    // A temporary directory is removed whether or not the workers and the merge succeed
+    try {
+        std::vector<std::string> files;
+        std::vector<int> status(options.workers, 0);
+        std::vector<std::thread> threads;
+        for (size_t k = 0; k < options.workers; ++k) {
+            files.push_back((directory / ("shard_" + std::to_string(k) + ".bin")).string());
+            std::string command = quote_argument(program) + " --shard " + std::to_string(k) + "/" +
+                                  std::to_string(options.workers) + " --output " +
+                                  quote_argument(files.back()) + (options.import ? " --import " : " ") +
+                                  quote_argument(options.inputFile);
+#ifdef _WIN32
+            // cmd.exe strips the outermost quotes of the whole command line
+            command = "\"" + command + "\"";
+#endif
+            threads.emplace_back([&status, k, command]() { status[k] = std::system(command.c_str()); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t k = 0; k < options.workers; ++k) {
+            if (status[k] != 0) {
+                throw std::runtime_error("Shard worker " + std::to_string(k) + " failed");
+            }
+        }
+
+        process_merge(files, options.countOnly);
+    } catch (...) {
+        if (temporary) {
+            std::error_code ignored;
+            fs::remove_all(directory, ignored);
+        }
+        throw;
+    }
+    if (temporary) {
+        fs::remove_all(directory);
+    }
+}
+
+// Run the selected analysis on a parsed expression and print its result
+static void process_tree(Node* parse_tree, const Options& options, ColumnCache* cache,
+                         MemoryMeter& meter) {
+    // Modes that print as they compute are measured as a whole under "evaluate"
+    meter.start("evaluate");
+    Evaluator evaluator(parse_tree);
+    if (!options.check.empty()) {
+        Checker checker(parse_tree);
+        print_check(checker, options.check);
+    } else if (options.sampleCount > 0) {
+        Sampler sampler(parse_tree, options.seed);
+        print_sample(sampler, options);
+    } else if (options.minimize) {
+        std::vector<std::string> variables;
+        std::vector<uint64_t> column = evaluator.generateResultColumn(variables);
+        print_minimized(variables, column);
+    } else if (!options.spillDirectory.empty()) {
+        // Each expression gets its own numbered table directory
+        static size_t tableIndex = 0;
+        std::string directory = (std::filesystem::path(options.spillDirectory) /
+                                 ("table_" + std::to_string(++tableIndex))).string();
+        ChunkedTableWriter writer(directory, options.maxMemory);
+        writer.write(evaluator, std::cout);
+    } else if (!options.columns.empty()) {
+        // Normalize each requested column by parsing it, so spacing and redundant
+        // parentheses do not matter
+        std::vector<std::string> selected;
+        for (const auto& column : options.columns) {
+            std::unique_ptr<Node> columnTree;
+            if (options.import) {
+                // Imported formulas may use variables such as X12, which the scanner rejects
+                std::istringstream columnInput(column);
+                BatchEvaluator columnDag;
+                if (!FormulaImporter(columnInput).next(columnDag)) {
+                    throw std::runtime_error("Empty column name");
+                }
+                columnTree.reset(columnDag.toTree(columnDag.getOutputs()[0]));
+            } else {
+                Scanner columnScanner(column);
+                std::vector<Token> columnTokens = columnScanner.getTokens();
+                Parser columnParser(columnTokens);
+                columnTree.reset(columnParser.parseSentence());
+            }
+            selected.push_back(evaluator.nodeToString(columnTree.get()));
+        }
+        TruthColumns table = evaluator.generateSelectedColumns(selected);
+        meter.start("print");
+        print_truth_table(table);
+    } else {
+        // Generate and print the truth table, reusing cached subexpression columns
+        TruthColumns table = evaluator.generateTruthColumns(cache);
+        meter.start("print");
+        print_truth_table(table);
+    }
+}
+
 // Add this function to process a single expression
-static void process_expression(const std::string& input_string) {
+static void process_expression(const std::string& input_string, const Options& options,
+                               ColumnCache* cache = nullptr) {
+    MemoryMeter meter;
     try {
         // Step 1: Tokenize the input string
+        meter.start("scan");
         Scanner scanner(input_string);
         std::vector<Token> tokens = scanner.getTokens();
 
         // Step 2: Parse the tokens into a parse tree
+        meter.start("parse");
         Parser parser(tokens);
         Node* parse_tree = parser.parseSentence();
 
-        // Step 3 & 4: Generate and print truth table
-        Evaluator evaluator(parse_tree);
-        auto [table, finalColumns] = evaluator.generateTruthTable();
+        // Step 3 & 4: Evaluate and print
+        process_tree(parse_tree, options, cache, meter);
 
-        std::cout << "Truth Table:\n";
+        // Clean up parse tree
+        delete parse_tree;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+    meter.stop();
+
+    if (options.memReport) {
+        print_memory_report(input_string, meter, options.memReportCsv);
+    }
+}
+
+// Run the selected analysis on an imported formula, the only output of its DAG
+static void process_dag(BatchEvaluator& dag, const Options& options, MemoryMeter& meter) {
+    meter.start("evaluate");
+    if (!options.check.empty()) {
+        Checker checker(std::move(dag), 0);
+        print_check(checker, options.check);
+    } else if (options.sampleCount > 0) {
+        Sampler sampler(std::move(dag), 0, options.seed);
+        print_sample(sampler, options);
+    } else if (options.minimize) {
+        TruthColumns table = dag.evaluate();
+        print_minimized(dag.getVariables(), table.columns.back());
+    } else {
+        // Tables show every subexpression, which only the syntax tree has
+        std::unique_ptr<Node> parse_tree(dag.toTree(dag.getOutputs()[0]));
+        process_tree(parse_tree.get(), options, nullptr, meter);
+    }
+}
 
-        // Calculate column widths
-        std::vector<size_t> columnWidths;
-        for (const auto& col : finalColumns) {
-            columnWidths.push_back(std::max(col.length(), size_t(5)) + 2); // minimum width of 5 plus padding
+// Import every formula of a file into one shared DAG, then evaluate it or compile it to a library
+static void process_import_batch(FormulaImporter& importer, const Options& options) {
+    MemoryMeter meter;
+    meter.start("import");
+    BatchEvaluator batch;
+    while (importer.next(batch)) {
+    }
+    batch.sortVariables();
+    batch.labelOutputs();
+    size_t formulas = batch.getOutputs().size();
+
+    if (options.compile) {
+        FormulaLibrary::write(batch, options.libraryPath);
+        std::cout << "Compiled " << formulas << " formula(s) (" << batch.distinctNodes()
+                  << " node(s)) to " << options.libraryPath << std::endl;
+        return;
+    }
+
+    meter.start("evaluate");
+    std::cout << "\nProcessing batch: " << formulas << " formula(s), "
+              << batch.distinctNodes() << " distinct node(s)" << std::endl;
+    TruthColumns table = batch.evaluate();
+
+    meter.start("print");
+    print_truth_table(table);
+    meter.stop();
+
+    if (options.memReport) {
+        print_memory_report("batch of " + std::to_string(formulas) + " formula(s)", meter,
+                            options.memReportCsv);
+    }
+}
+
+// Import formulas one at a time and write this process's shard of each to one shard file
+static void process_import_shard(FormulaImporter& importer, const Options& options) {
+    std::ofstream out = open_shard_output(options);
+
+    size_t failed = 0;
+    for (size_t position = 0; ; ++position) {
+        BatchEvaluator dag;
+        if (!importer.next(dag)) break;
+        dag.sortVariables();
+        dag.labelOutputs();
+        try {
+            writeShard(out, computeShard(dag, 0, position, options.shardIndex, options.shardCount));
+        } catch (const std::exception& e) {
+            std::cout << "Error in formula " << position + 1 << ": " << e.what() << std::endl;
+            ++failed;
         }
+    }
+    close_shard_output(out, options, failed);
+}
 
-        // Print header with proper alignment
-        for (size_t i = 0; i < finalColumns.size(); ++i) {
-            std::cout << std::left << std::setw(columnWidths[i]) << finalColumns[i] << "|";
+// Stream the formulas of a DIMACS CNF or multi-line infix file and analyze each in turn
+static void process_import(const Options& options) {
+    std::ifstream file(options.inputFile, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + options.inputFile);
+    }
+
+    FormulaImporter importer(file);
+    if (options.batch || options.compile) {
+        process_import_batch(importer, options);
+        return;
+    }
+    if (options.shardCount > 0) {
+        process_import_shard(importer, options);
+        return;
+    }
+
+    for (size_t index = 1; ; ++index) {
+        MemoryMeter meter;
+        meter.start("import");
+        BatchEvaluator dag;
+        if (!importer.next(dag)) break;
+        dag.sortVariables();
+
+        std::cout << "\nProcessing: " << options.inputFile;
+        if (importer.getFormat() == FormulaImporter::Format::DIMACS) {
+            std::cout << " (DIMACS CNF, " << importer.getDeclaredVariables() << " variable(s), "
+                      << importer.getClauseCount() << " clause(s))" << std::endl;
+        } else {
+            std::cout << " (formula " << index << ")" << std::endl;
         }
-        std::cout << "\n";
 
-        // Print separator line
-        for (const auto& width : columnWidths) {
-            std::cout << std::string(width, '-') << "+";
+        try {
+            process_dag(dag, options, meter);
+        } catch (const std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
         }
-        std::cout << "\n";
+        meter.stop();
 
-        // Print rows with proper alignment
-        for (const auto& row : table) {
-            const auto& values = row.first;
-            const auto& results = row.second;
+        if (options.memReport) {
+            print_memory_report(options.inputFile + " #" + std::to_string(index), meter,
+                                options.memReportCsv);
+        }
+    }
+}
 
-            for (size_t i = 0; i < finalColumns.size(); ++i) {
-                const auto& col = finalColumns[i];
-                bool value;
-                if (values.find(col) != values.end()) {
-                    value = values.at(col);
-                } else {
-                    value = results.at(col);
-                }
-                std::cout << std::left << std::setw(columnWidths[i]) << (value ? "T" : "F") << "|";
-            }
-            std::cout << "\n";
+// Replace every bound name (a run of lowercase letters) with its parenthesized formula
+static std::string expand_bindings(const std::string& input_string,
+                                   const std::unordered_map<std::string, std::string>& bindings) {
+    std::string expanded;
+    size_t current = 0;
+    while (current < input_string.length()) {
+        if (!std::islower(static_cast<unsigned char>(input_string[current]))) {
+            expanded += input_string[current++];
+            continue;
         }
 
-        // Clean up parse tree
-        delete parse_tree;
+        size_t start = current;
+        while (current < input_string.length() &&
+               std::islower(static_cast<unsigned char>(input_string[current]))) {
+            current++;
+        }
+        std::string name = input_string.substr(start, current - start);
+        auto it = bindings.find(name);
+        expanded += (it != bindings.end()) ? "(" + it->second + ")" : name;
+    }
+    return expanded;
+}
+
+// Handle ":let name = formula", binding a lowercase name to a validated formula
+static void define_binding(const std::string& definition,
+                           std::unordered_map<std::string, std::string>& bindings) {
+    try {
+        size_t equals = definition.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("Expected ':let name = formula'");
+        }
+
+        std::string name = definition.substr(0, equals);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name.empty() || !std::all_of(name.begin(), name.end(),
+                                         [](unsigned char c) { return std::islower(c); })) {
+            throw std::runtime_error("Binding names must be lowercase letters: '" + name + "'");
+        }
+
+        // Expand earlier bindings now so each stored formula is self-contained
+        std::string formula = expand_bindings(definition.substr(equals + 1), bindings);
+        Scanner scanner(formula);
+        std::vector<Token> tokens = scanner.getTokens();
+        Parser parser(tokens);
+        delete parser.parseSentence();
+
+        formula.erase(0, formula.find_first_not_of(" \t"));
+        formula.erase(formula.find_last_not_of(" \t") + 1);
+        bindings[name] = formula;
+        std::cout << "Bound " << name << " = " << formula << std::endl;
     } catch (const std::exception& e) {
         std::cout << "Error: " << e.what() << std::endl;
     }
 }
 
 int main(int argc, char* argv[]) {
-    if (argc > 2) {
-        std::cout << "Usage: " << argv[0] << " [input_file]" << std::endl;
+    Options options;
+    try {
+        options = parse_arguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        std::cout << "Usage: " << argv[0] << " [--minimize | --columns <col,...>] [input_file]" << std::endl;
+        std::cout << "       " << argv[0] << " --batch <input_file>" << std::endl;
+        std::cout << "       " << argv[0] << " --spill <dir> [--max-memory <size>] [input_file]" << std::endl;
+        std::cout << "       " << argv[0] << " [--mem-report | --mem-report-csv] [input_file]" << std::endl;
+        std::cout << "       " << argv[0] << " --import [--sample <N> | --check <...> | ...] <cnf_or_formula_file>" << std::endl;
+        std::cout << "       " << argv[0] << " --check <valid|sat|unsat> [input_file]" << std::endl;
+        std::cout << "       " << argv[0] << " --sample <N> [--seed <S>] [input_file]" << std::endl;
+        std::cout << "       " << argv[0] << " --bulk <formula> [assignments.csv]" << std::endl;
+        std::cout << "       " << argv[0] << " --shard <k/N> --output <file> <input_file>" << std::endl;
+        std::cout << "       " << argv[0] << " --workers <N> [--output <dir>] [--count] <input_file>" << std::endl;
+        std::cout << "       " << argv[0] << " merge [--count] <shard_file>..." << std::endl;
+        std::cout << "       " << argv[0] << " compile <input_file> <library_file>" << std::endl;
+        std::cout << "       " << argv[0] << " --library <library_file>" << std::endl;
         return 1;
     }
 
-    if (argc == 2) {
+    if (options.merge) {
+        try {
+            process_merge(options.mergeFiles, options.countOnly);
+        } catch (const std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.compile || !options.libraryPath.empty()) {
+        try {
+            if (options.compile && options.import) {
+                process_import(options);
+            } else if (options.compile) {
+                process_compile(read_input_file(options.inputFile), options.libraryPath);
+            } else {
+                process_library(options.libraryPath);
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.workers > 0) {
+        try {
+            process_workers(argv[0], options);
+        } catch (const std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.bulk) {
+        // Bulk mode: assignments come from the given CSV file or stdin
+        try {
+            if (options.inputFile.empty()) {
+                process_bulk(options.bulkFormula, std::cin);
+            } else {
+                std::ifstream file(options.inputFile, std::ios::binary);
+                if (!file.is_open()) {
+                    throw std::runtime_error("Could not open assignment file: " + options.inputFile);
+                }
+                process_bulk(options.bulkFormula, file);
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!options.inputFile.empty()) {
         // File input mode
         try {
-            std::vector<std::string> inputs = read_input_file(argv[1]);
+            if (options.import) {
+                process_import(options);
+                return 0;
+            }
+            std::vector<std::string> inputs = read_input_file(options.inputFile);
+            if (options.batch) {
+                process_batch(inputs, options);
+                return 0;
+            }
+            if (options.shardCount > 0) {
+                process_shard(inputs, options);
+                return 0;
+            }
             for (const auto& input_string : inputs) {
                 std::cout << "\nProcessing: " << input_string << std::endl;
-                process_expression(input_string);
+                process_expression(input_string, options);
             }
         } catch (const std::exception& e) {
             std::cout << "Error: " << e.what() << std::endl;
@@ -109,18 +1010,31 @@ int main(int argc, char* argv[]) {
         // Interactive mode
         std::cout << "CMSC 124 - Propositional Logic Evaluator" << std::endl;
         std::cout << "Enter 'exit' to terminate the program." << std::endl;
+        std::cout << "Enter ':let name = formula' to name a subformula for later inputs." << std::endl;
+
+        // Subexpression columns and bindings persist across inputs, so an edited
+        // formula only recomputes the subtrees that changed
+        ColumnCache cache;
+        std::unordered_map<std::string, std::string> bindings;
 
         while (true) {
             std::cout << "\nEnter a propositional logic: ";
             std::string input_string;
-            std::getline(std::cin, input_string);
+            if (!std::getline(std::cin, input_string)) {
+                break;
+            }
 
             if (input_string == "exit") {
                 std::cout << "Program terminated." << std::endl;
                 break;
             }
 
-            process_expression(input_string);
+            if (input_string.rfind(":let", 0) == 0) {
+                define_binding(input_string.substr(4), bindings);
+                continue;
+            }
+
+            process_expression(expand_bindings(input_string, bindings), options, &cache);
         }
     }
 
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include "../include/MemoryStats.h"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#ifdef LOGIC_MEM_STATS
+
+static std::atomic<uint64_t> allocationCount{0};
+static std::atomic<uint64_t> allocatedBytes{0};
+static std::atomic<uint64_t> liveBytes{0};
+static std::atomic<uint64_t> peakBytes{0};
+
+// Every block is preceded by its size, padded so the block keeps malloc's alignment
+static const size_t kHeaderSize = alignof(std::max_align_t);
+
+static void countAllocation(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    uint64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+static void* countedAllocate(std::size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + kHeaderSize));
+    if (!block) return nullptr;
+    *reinterpret_cast<std::size_t*>(block) = size;
+    countAllocation(size);
+    return block + kHeaderSize;
+}
+
+static void countedFree(void* pointer) {
+    if (!pointer) return;
+    char* block = static_cast<char*>(pointer) - kHeaderSize;
+    liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+// Over-aligned blocks are placed inside a larger malloc block; the size and the
+// start of that block are stored in the two words just below the returned pointer
+static void* countedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t header = 2 * sizeof(void*);
+    char* block = static_cast<char*>(std::malloc(size + align + header));
+    if (!block) return nullptr;
+
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(block) + header;
+    char* pointer = block + ((first + align - 1) / align * align - reinterpret_cast<std::uintptr_t>(block));
+    reinterpret_cast<std::size_t*>(pointer)[-2] = size;
+    reinterpret_cast<char**>(pointer)[-1] = block;
+    countAllocation(size);
+    return pointer;
+}
+
+static void countedFreeAligned(void* pointer) {
+    if (!pointer) return;
+    liveBytes.fetch_sub(reinterpret_cast<std::size_t*>(pointer)[-2], std::memory_order_relaxed);
+    std::free(reinterpret_cast<char**>(pointer)[-1]);
+}
+
+static void* allocateOrThrow(std::size_t size) {
+    while (true) {
+        void* pointer = countedAllocate(size);
+        if (pointer) return pointer;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment) {
+    while (true) {
+        void* pointer = countedAllocateAligned(size, alignment);
+        if (pointer) return pointer;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+
+// Types aligned beyond max_align_t are allocated through the align_val_t overloads
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateAlignedOrThrow(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateAlignedOrThrow(size, alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocateAligned(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocateAligned(size, alignment);
+}
+void operator delete(void* pointer, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { countedFreeAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    countedFreeAligned(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    countedFreeAligned(pointer);
+}
+
+/**
+ * @brief Reports whether allocations are being counted
+ * @return bool True if built with LOGIC_MEM_STATS
+ */
+bool memoryCountingEnabled() {
+    return true;
+}
+
+/**
+ * @brief Reads the allocation counters
+ * @return MemoryCounters The current values
+ */
+MemoryCounters memoryCounters() {
+    MemoryCounters counters;
+    counters.allocations = allocationCount.load(std::memory_order_relaxed);
+    counters.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    counters.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    counters.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+/**
+ * @brief Restarts peak tracking from the current live byte count
+ */
+void resetMemoryPeak() {
+    peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+#else
+
+bool memoryCountingEnabled() {
+    return false;
+}
+
+MemoryCounters memoryCounters() {
+    return MemoryCounters();
+}
+
+void resetMemoryPeak() {}
+
+#endif // LOGIC_MEM_STATS
+
+/**
+ * @brief Retrieves the peak resident set size of the process since start-up
+ * @return uint64_t Bytes, or 0 where the platform does not report it
+ */
+uint64_t peakResidentBytes() {
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);          // Bytes on macOS
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // Kilobytes on Linux
+#endif
+#endif
+}
+
+/**
+ * @brief Starts measuring a stage, ending the previous one
+ * @param stage Name of the stage
+ */
+void MemoryMeter::start(const std::string& stage) {
+    stop();
+
+    current = 0;
+    while (current < stages.size() && stages[current].stage != stage) ++current;
+    if (current == stages.size()) {
+        stages.emplace_back();
+        stages.back().stage = stage;
+    }
+
+    running = true;
+    resetMemoryPeak();
+    begin = memoryCounters();
+}
+
+/**
+ * @brief Ends the running stage
+ */
+void MemoryMeter::stop() {
+    if (!running) return;
+    running = false;
+
+    MemoryCounters end = memoryCounters();
+    StageUsage& usage = stages[current];
+    usage.allocations += end.allocations - begin.allocations;
+    usage.bytes += end.bytes - begin.bytes;
+    usage.peakBytes = std::max(usage.peakBytes, end.peakBytes);
+}
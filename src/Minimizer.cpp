@@ -0,0 +1,580 @@
+#include <algorithm>
+#include <bitset>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include "../include/Minimizer.h"
+
+// Cubes at least this large have their expansion candidates checked in parallel
+static const size_t kParallelCubeRows = size_t(1) << 14;
+
+// Merge passes over at least this many implicants are split across the workers
+static const size_t kParallelImplicants = size_t(1) << 12;
+
+/**
+ * @brief Fixed set of threads that run one job at a time
+ *
+ * Minimization runs many short parallel steps (one per merge pass or cube
+ * expansion), so the threads are started once per cover and woken for each
+ * step instead of being created every time.
+ */
+class Minimizer::WorkerPool {
+public:
+    /**
+     * @brief Starts the pool
+     * @param size Number of workers, counting the thread that calls run()
+     */
+    explicit WorkerPool(size_t size) {
+        for (size_t worker = 1; worker < size; ++worker) {
+            threads.emplace_back([this, worker]() { serve(worker); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t size() const { return threads.size() + 1; }
+
+    /**
+     * @brief Runs job(worker, size()) on every worker and waits for all of them
+     * @param job The step to run; the calling thread is worker 0
+     */
+    void run(const std::function<void(size_t, size_t)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &job;
+            running = threads.size();
+            error = nullptr;
+            ++generation;
+        }
+        wake.notify_all();
+
+        std::exception_ptr own;
+        try {
+            job(0, size());
+        } catch (...) {
+            own = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return running == 0; });
+        current = nullptr;
+        if (own) std::rethrow_exception(own);
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;       // Signalled when a job is posted or on stop
+    std::condition_variable done;       // Signalled when the last worker finishes a job
+    const std::function<void(size_t, size_t)>* current = nullptr;
+    size_t generation = 0;              // Number of jobs posted so far
+    size_t running = 0;                 // Workers still busy with the current job
+    bool stopping = false;
+    std::exception_ptr error;           // First failure of a worker thread
+
+    void serve(size_t worker) {
+        size_t seen = 0;
+        while (true) {
+            const std::function<void(size_t, size_t)>* job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                job = current;
+            }
+
+            std::exception_ptr failure;
+            try {
+                (*job)(worker, size());
+            } catch (...) {
+                failure = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failure && !error) error = failure;
+            if (--running == 0) done.notify_one();
+        }
+    }
+};
+
+/**
+ * @brief Constructs a minimizer for a packed result column
+ * @param variables Variable names; variable j is bit j of the row index
+ * @param column One bit per row, 64 rows per word
+ * @throws std::runtime_error if there are too many variables or the column is too short
+ */
+Minimizer::Minimizer(const std::vector<std::string>& variables, const std::vector<uint64_t>& column)
+    : variables(variables), column(column) {
+    if (variables.size() > kMaxVariables) {
+        throw std::runtime_error("Cannot minimize more than " + std::to_string(kMaxVariables) +
+                                 " variables");
+    }
+    size_t numRows = size_t(1) << variables.size();
+    if (column.size() < (numRows + 63) / 64) {
+        throw std::runtime_error("Result column is shorter than the truth table");
+    }
+}
+
+/**
+ * @brief Collects the rows whose result equals the requested value
+ * @param value True for minterms, false for maxterms
+ * @return std::vector<uint32_t> The matching row indices in ascending order
+ */
+std::vector<uint32_t> Minimizer::collectRows(bool value) const {
+    std::vector<uint32_t> rows;
+    size_t numRows = size_t(1) << variables.size();
+    for (size_t row = 0; row < numRows; ++row) {
+        bool bit = (column[row / 64] >> (row % 64)) & 1;
+        if (bit == value) {
+            rows.push_back(static_cast<uint32_t>(row));
+        }
+    }
+    return rows;
+}
+
+/**
+ * @brief Finds all prime implicants covering the given rows
+ * @param rows The row indices that must be covered, in ascending order
+ * @param primes Receives the prime implicants
+ * @param pool Workers sharing the merge passes
+ * @return bool False if more than kMaxPrimes implicants would be needed
+ */
+bool Minimizer::primeImplicants(const std::vector<uint32_t>& rows, std::vector<Implicant>& primes,
+                                WorkerPool& pool) const {
+    auto key = [](const Implicant& imp) { return (uint64_t(imp.mask) << 32) | imp.value; };
+
+    // Each pass keeps its implicants sorted by key, so partners are found by binary
+    // search in a table every worker can read
+    std::vector<Implicant> current;
+    std::vector<uint64_t> keys;
+    for (uint32_t row : rows) {
+        current.push_back({row, 0});
+    }
+
+    primes.clear();
+    std::vector<std::vector<Implicant>> merged(pool.size());
+    while (!current.empty()) {
+        if (primes.size() + current.size() > kMaxPrimes) {
+            return false;
+        }
+
+        keys.resize(current.size());
+        std::transform(current.begin(), current.end(), keys.begin(), key);
+        auto present = [&](const Implicant& imp) {
+            return std::binary_search(keys.begin(), keys.end(), key(imp));
+        };
+
+        // An implicant is used if it has a partner differing in one cared-for bit;
+        // only the partner with that bit clear emits the merged implicant
+        std::vector<char> used(current.size(), 0);
+        auto pass = [&](size_t worker, size_t workers) {
+            merged[worker].clear();
+            size_t first = current.size() * worker / workers;
+            size_t last = current.size() * (worker + 1) / workers;
+            for (size_t i = first; i < last; ++i) {
+                const Implicant& imp = current[i];
+                for (size_t b = 0; b < variables.size(); ++b) {
+                    uint32_t bit = uint32_t(1) << b;
+                    if ((imp.mask & bit) || !present({imp.value ^ bit, imp.mask})) continue;
+
+                    used[i] = 1;
+                    if (!(imp.value & bit)) {
+                        merged[worker].push_back({imp.value, imp.mask | bit});
+                    }
+                }
+            }
+        };
+        if (current.size() >= kParallelImplicants && pool.size() > 1) {
+            pool.run(pass);
+        } else {
+            pass(0, 1);
+        }
+
+        for (size_t i = 0; i < current.size(); ++i) {
+            if (!used[i]) primes.push_back(current[i]);
+        }
+
+        // The same implicant can come from several pairs, so sort and drop repeats
+        std::vector<Implicant> next;
+        for (auto& part : merged) {
+            next.insert(next.end(), part.begin(), part.end());
+            part.clear();
+        }
+        std::sort(next.begin(), next.end(), [&](const Implicant& a, const Implicant& b) {
+            return key(a) < key(b);
+        });
+        next.erase(std::unique(next.begin(), next.end(), [&](const Implicant& a, const Implicant& b) {
+            return key(a) == key(b);
+        }), next.end());
+        current.swap(next);
+    }
+
+    return primes.size() <= kMaxPrimes;
+}
+
+/**
+ * @brief Selects a minimum set of prime implicants covering every row
+ * @param primes The candidate prime implicants
+ * @param rows The row indices that must be covered, in ascending order
+ * @param exact Set to false if the search budget ran out
+ * @return std::vector<Implicant> The chosen cover
+ */
+std::vector<Minimizer::Implicant> Minimizer::selectCover(const std::vector<Implicant>& primes,
+                                                         const std::vector<uint32_t>& rows,
+                                                         bool& exact) const {
+    // Build the coverage chart by walking the subsets of each implicant's mask
+    std::vector<std::vector<size_t>> primeRows(primes.size());
+    std::vector<std::vector<size_t>> rowPrimes(rows.size());
+    for (size_t p = 0; p < primes.size(); ++p) {
+        uint32_t sub = 0;
+        do {
+            uint32_t row = primes[p].value | sub;
+            size_t pos = std::lower_bound(rows.begin(), rows.end(), row) - rows.begin();
+            primeRows[p].push_back(pos);
+            rowPrimes[pos].push_back(p);
+            sub = (sub - primes[p].mask) & primes[p].mask;
+        } while (sub != 0);
+    }
+
+    auto totalLiterals = [&](const std::vector<size_t>& chosen) {
+        size_t total = 0;
+        for (size_t p : chosen) total += literalCount(primes[p]);
+        return total;
+    };
+
+    // Greedy cover: repeatedly take the implicant covering the most uncovered rows, fewest
+    // literals first on ties. Gains only shrink, so a stale queue entry is rechecked lazily
+    std::vector<size_t> best;
+    {
+        std::vector<char> covered(rows.size(), 0);
+        auto gainOf = [&](size_t p) {
+            size_t gain = 0;
+            for (size_t pos : primeRows[p]) gain += !covered[pos];
+            return gain;
+        };
+        auto worse = [&](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+            if (a.first != b.first) return a.first < b.first;
+            if (literalCount(primes[a.second]) != literalCount(primes[b.second])) {
+                return literalCount(primes[a.second]) > literalCount(primes[b.second]);
+            }
+            return a.second > b.second;
+        };
+        std::priority_queue<std::pair<size_t, size_t>, std::vector<std::pair<size_t, size_t>>,
+                            decltype(worse)> queue(worse);
+        for (size_t p = 0; p < primes.size(); ++p) {
+            queue.emplace(primeRows[p].size(), p);
+        }
+
+        size_t remaining = rows.size();
+        while (remaining > 0) {
+            auto [gain, p] = queue.top();
+            queue.pop();
+            size_t current = gainOf(p);
+            if (current != gain) {
+                if (current > 0) queue.emplace(current, p);
+                continue;
+            }
+            best.push_back(p);
+            for (size_t pos : primeRows[p]) {
+                if (!covered[pos]) {
+                    covered[pos] = 1;
+                    --remaining;
+                }
+            }
+        }
+    }
+
+    {
+        std::vector<int> coverCount(rows.size(), 0);
+        std::vector<size_t> chosen;
+        auto choose = [&](size_t p, int delta) {
+            for (size_t pos : primeRows[p]) coverCount[pos] += delta;
+        };
+
+        // Essential prime implicants are the only cover of some row
+        std::vector<char> isChosen(primes.size(), 0);
+        for (size_t pos = 0; pos < rows.size(); ++pos) {
+            if (rowPrimes[pos].size() == 1 && !isChosen[rowPrimes[pos][0]]) {
+                isChosen[rowPrimes[pos][0]] = 1;
+                chosen.push_back(rowPrimes[pos][0]);
+                choose(rowPrimes[pos][0], 1);
+            }
+        }
+
+        // Branch and bound over the rows the essentials leave open, starting from the greedy bound
+        std::vector<size_t> open;
+        for (size_t pos = 0; pos < rows.size(); ++pos) {
+            if (coverCount[pos] == 0) open.push_back(pos);
+        }
+
+        size_t budget = 10000;
+        size_t bestLiterals = totalLiterals(best);
+        std::function<void()> search = [&]() {
+            size_t row = rows.size();
+            for (size_t pos : open) {
+                if (coverCount[pos] == 0 &&
+                    (row == rows.size() || rowPrimes[pos].size() < rowPrimes[row].size())) {
+                    row = pos;
+                }
+            }
+
+            if (row == rows.size()) {
+                size_t literals = totalLiterals(chosen);
+                if (chosen.size() < best.size() ||
+                    (chosen.size() == best.size() && literals < bestLiterals)) {
+                    best = chosen;
+                    bestLiterals = literals;
+                }
+                return;
+            }
+
+            if (chosen.size() + 1 > best.size() || budget == 0) return;
+            --budget;
+
+            for (size_t p : rowPrimes[row]) {
+                chosen.push_back(p);
+                choose(p, 1);
+                search();
+                choose(p, -1);
+                chosen.pop_back();
+            }
+        };
+        search();
+        exact = budget > 0;
+    }
+
+    std::vector<Implicant> cover;
+    for (size_t p : best) {
+        cover.push_back(primes[p]);
+    }
+    return cover;
+}
+
+/**
+ * @brief Builds a near-minimal cover by expanding rows into large cubes
+ * @param value True for minterms, false for maxterms
+ * @param pool Workers sharing the checks of large cubes
+ * @return std::vector<Implicant> An irredundant cover of the matching rows
+ */
+std::vector<Minimizer::Implicant> Minimizer::expandCover(bool value, WorkerPool& pool) const {
+    const size_t n = variables.size();
+    const size_t numRows = size_t(1) << n;
+
+    // Number of chosen cubes containing each row
+    std::vector<uint32_t> coverCount(numRows, 0);
+    auto forEachRow = [](const Implicant& cube, const std::function<void(uint32_t)>& visit) {
+        uint32_t sub = 0;
+        do {
+            visit(cube.value | sub);
+            sub = (sub - cube.mask) & cube.mask;
+        } while (sub != 0);
+    };
+
+    std::vector<Implicant> cubes;
+    std::vector<char> valid(n);
+    std::vector<size_t> gain(n);
+    for (uint32_t seed = 0; seed < numRows; ++seed) {
+        if (!rowMatches(seed, value) || coverCount[seed] > 0) continue;
+
+        // Expand: repeatedly raise the variable whose added half stays inside the
+        // function and holds the most uncovered rows
+        Implicant cube{seed, 0};
+        while (true) {
+            auto check = [&](size_t first, size_t step) {
+                for (size_t j = first; j < n; j += step) {
+                    uint32_t bit = uint32_t(1) << j;
+                    valid[j] = !(cube.mask & bit);
+                    gain[j] = 0;
+                    if (!valid[j]) continue;
+
+                    uint32_t half = cube.value ^ bit;
+                    uint32_t sub = 0;
+                    do {
+                        uint32_t row = half | sub;
+                        if (!rowMatches(row, value)) {
+                            valid[j] = 0;
+                            break;
+                        }
+                        gain[j] += coverCount[row] == 0;
+                        sub = (sub - cube.mask) & cube.mask;
+                    } while (sub != 0);
+                }
+            };
+
+            size_t cubeRows = size_t(1) << std::bitset<32>(cube.mask).count();
+            if (cubeRows >= kParallelCubeRows && pool.size() > 1) {
+                pool.run(check);
+            } else {
+                check(0, 1);
+            }
+
+            size_t chosen = n;
+            for (size_t j = 0; j < n; ++j) {
+                if (valid[j] && (chosen == n || gain[j] > gain[chosen])) chosen = j;
+            }
+            if (chosen == n) break;
+            cube.mask |= uint32_t(1) << chosen;
+            cube.value &= ~(uint32_t(1) << chosen);
+        }
+
+        forEachRow(cube, [&](uint32_t row) { ++coverCount[row]; });
+        cubes.push_back(cube);
+    }
+
+    // Irredundant: drop cubes, smallest first, whose rows are all covered by others
+    std::vector<size_t> order(cubes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return literalCount(cubes[a]) > literalCount(cubes[b]);
+    });
+
+    std::vector<char> kept(cubes.size(), 1);
+    for (size_t i : order) {
+        bool redundant = true;
+        forEachRow(cubes[i], [&](uint32_t row) { redundant = redundant && coverCount[row] > 1; });
+        if (redundant) {
+            forEachRow(cubes[i], [&](uint32_t row) { --coverCount[row]; });
+            kept[i] = 0;
+        }
+    }
+
+    std::vector<Implicant> cover;
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        if (kept[i]) cover.push_back(cubes[i]);
+    }
+    return cover;
+}
+
+/**
+ * @brief Finds a small cover of the rows with the requested value
+ * @param rows The matching row indices, in ascending order
+ * @param value True for minterms, false for maxterms
+ * @param exact Set to false when the cover is only near-minimal
+ * @return std::vector<Implicant> The chosen cover, sorted for printing
+ */
+std::vector<Minimizer::Implicant> Minimizer::findCover(const std::vector<uint32_t>& rows, bool value,
+                                                       bool& exact) const {
+    exact = true;
+    std::vector<Implicant> cover;
+    std::vector<Implicant> primes;
+    WorkerPool pool(std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+    bool useExact = variables.size() <= kMaxExactVariables && primeImplicants(rows, primes, pool);
+    if (useExact) {
+        size_t chartEntries = 0;
+        for (const auto& prime : primes) {
+            chartEntries += size_t(1) << std::bitset<32>(prime.mask).count();
+        }
+        useExact = chartEntries <= kMaxChartEntries;
+    }
+
+    if (useExact) {
+        cover = selectCover(primes, rows, exact);
+    } else {
+        cover = expandCover(value, pool);
+        exact = false;
+    }
+
+    std::sort(cover.begin(), cover.end(), [&](const Implicant& a, const Implicant& b) {
+        if (literalCount(a) != literalCount(b)) return literalCount(a) < literalCount(b);
+        if (a.mask != b.mask) return a.mask > b.mask;
+        return a.value < b.value;
+    });
+    return cover;
+}
+
+/**
+ * @brief Counts the literals of an implicant
+ * @param implicant The implicant to measure
+ * @return size_t Number of variables not eliminated by the mask
+ */
+size_t Minimizer::literalCount(const Implicant& implicant) const {
+    size_t count = 0;
+    for (size_t j = 0; j < variables.size(); ++j) {
+        if (!(implicant.mask & (uint32_t(1) << j))) ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief Formats an implicant as a conjunction or a disjunction of literals
+ * @param implicant The implicant to format
+ * @param asClause True to emit the negated clause used by product-of-sums
+ * @return std::string The formatted term
+ */
+std::string Minimizer::formatTerm(const Implicant& implicant, bool asClause) const {
+    std::string term;
+    for (size_t j = 0; j < variables.size(); ++j) {
+        uint32_t bit = uint32_t(1) << j;
+        if (implicant.mask & bit) continue;
+
+        bool positive = (implicant.value & bit) != 0;
+        if (asClause) positive = !positive;
+
+        if (!term.empty()) term += asClause ? " OR " : " AND ";
+        term += positive ? variables[j] : "NOT " + variables[j];
+    }
+    return term;
+}
+
+/**
+ * @brief Formats a cover as a sum of products or a product of sums
+ * @param cover The implicants to format
+ * @param asClauses True to emit the product-of-sums form
+ * @return std::string The expression in the evaluator's input syntax
+ */
+std::string Minimizer::formatCover(const std::vector<Implicant>& cover, bool asClauses) const {
+    std::string result;
+    for (const auto& imp : cover) {
+        if (!result.empty()) result += asClauses ? " AND " : " OR ";
+        std::string term = formatTerm(imp, asClauses);
+        result += (cover.size() > 1 && literalCount(imp) > 1) ? "(" + term + ")" : term;
+    }
+    return result;
+}
+
+/**
+ * @brief Computes a minimal sum-of-products form
+ * @param exact Set to false when the result is only near-minimal
+ * @return std::string The expression in the evaluator's input syntax
+ */
+std::string Minimizer::minimalSOP(bool& exact) const {
+    exact = true;
+    std::vector<uint32_t> rows = collectRows(true);
+    if (rows.empty()) return "FALSE";
+    if (rows.size() == (size_t(1) << variables.size())) return "TRUE";
+
+    return formatCover(findCover(rows, true, exact), false);
+}
+
+/**
+ * @brief Computes a minimal product-of-sums form
+ * @param exact Set to false when the result is only near-minimal
+ * @return std::string The expression in the evaluator's input syntax
+ */
+std::string Minimizer::minimalPOS(bool& exact) const {
+    // Each implicant of the complement becomes one clause by De Morgan's law
+    exact = true;
+    std::vector<uint32_t> rows = collectRows(false);
+    if (rows.empty()) return "TRUE";
+    if (rows.size() == (size_t(1) << variables.size())) return "FALSE";
+
+    return formatCover(findCover(rows, false, exact), true);
+}
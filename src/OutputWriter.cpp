@@ -0,0 +1,116 @@
+#include "../include/OutputWriter.h"
+
+/**
+ * @brief Starts the writer thread
+ * @param file Destination stream; it must stay open while the writer exists
+ * @param blockSize Bytes collected before a block is handed to the writer thread
+ * @param maxPending Maximum number of full blocks waiting to be written
+ */
+OutputWriter::OutputWriter(std::FILE* file, size_t blockSize, size_t maxPending)
+    : file(file), blockSize(blockSize), maxPending(maxPending),
+      writing(false), stopping(false), failed(false) {
+    current.reserve(blockSize);
+    thread = std::thread(&OutputWriter::run, this);
+}
+
+/**
+ * @brief Writes all remaining output and stops the writer thread
+ */
+OutputWriter::~OutputWriter() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Destructors must not throw; callers that care call flush() themselves
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_one();
+    thread.join();
+}
+
+/**
+ * @brief Appends bytes to the output
+ * @param data The bytes to append
+ * @param size Number of bytes
+ * @throws std::runtime_error if an earlier write to the file failed
+ */
+void OutputWriter::write(const char* data, size_t size) {
+    current.append(data, size);
+    if (current.size() >= blockSize) {
+        submit();
+    }
+}
+
+/**
+ * @brief Waits until everything appended so far has reached the file
+ * @throws std::runtime_error if a write to the file failed
+ */
+void OutputWriter::flush() {
+    if (!current.empty()) {
+        submit();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return pending.empty() && !writing; });
+    if (std::fflush(file) != 0) failed = true;
+    if (failed) {
+        throw std::runtime_error("Failed to write output");
+    }
+}
+
+/**
+ * @brief Queues the current block, waiting while the queue is full
+ */
+void OutputWriter::submit() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (failed) {
+        throw std::runtime_error("Failed to write output");
+    }
+
+    // Backpressure: the producer waits for the writer instead of queueing without bound
+    drained.wait(lock, [this] { return pending.size() < maxPending; });
+    pending.push_back(std::move(current));
+
+    if (!spare.empty()) {
+        current = std::move(spare.back());
+        spare.pop_back();
+    } else {
+        current = std::string();
+        current.reserve(blockSize);
+    }
+    current.clear();
+
+    lock.unlock();
+    ready.notify_one();
+}
+
+/**
+ * @brief Writer thread body: writes queued blocks until stopped
+ */
+void OutputWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this] { return !pending.empty() || stopping; });
+        if (pending.empty()) {
+            return;
+        }
+
+        std::string block = std::move(pending.front());
+        pending.pop_front();
+        writing = true;
+
+        lock.unlock();
+        bool ok = std::fwrite(block.data(), 1, block.size(), file) == block.size();
+        lock.lock();
+
+        if (!ok) failed = true;
+        writing = false;
+        if (spare.size() < maxPending) {
+            spare.push_back(std::move(block));
+        }
+        drained.notify_all();
+    }
+}
@@ -0,0 +1,139 @@
+#include <cmath>
+#include <algorithm>
+#include <bitset>
+#include <utility>
+#include "../include/Sampler.h"
+
+// Upper bound on the words held in one block of random assignment columns
+static const size_t kBlockWordBudget = size_t(1) << 20;
+
+// Rows per block when only a few variables are involved
+static const size_t kMaxBlockWords = 1024;
+
+// Index of the lowest set bit of a non-zero word
+static size_t lowestBit(uint64_t x) {
+    return std::bitset<64>((x & (~x + 1)) - 1).count();
+}
+
+static uint64_t rotateLeft(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Advances a splitmix64 state, used to expand the seed
+ * @param x State to advance
+ * @return uint64_t The next output
+ */
+static uint64_t splitMix(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Constructs a sampler for an expression
+ * @param root Root of the expression's syntax tree; it is only read while compiling
+ * @param seed Seed of the random generator; equal seeds give equal results
+ */
+Sampler::Sampler(Node* root, uint64_t seed) : Sampler(BatchEvaluator({root}), 0, seed) {
+}
+
+/**
+ * @brief Constructs a sampler for one formula of a compiled DAG
+ * @param dag The DAG; examples list the variables in its order
+ * @param output Index of the formula in the DAG
+ * @param seed Seed of the random generator; equal seeds give equal results
+ */
+Sampler::Sampler(BatchEvaluator dag, size_t output, uint64_t seed)
+    : compiled(std::move(dag)), output(output) {
+    for (auto& word : state) {
+        word = splitMix(seed);
+    }
+}
+
+/**
+ * @brief Fills a buffer with random words
+ * @param words Destination buffer
+ * @param count Number of words to generate
+ */
+void Sampler::fill(uint64_t* words, size_t count) {
+    uint64_t s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3];
+    for (size_t i = 0; i < count; ++i) {
+        words[i] = rotateLeft(s1 * 5, 7) * 9;
+        uint64_t t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotateLeft(s3, 45);
+    }
+    state[0] = s0; state[1] = s1; state[2] = s2; state[3] = s3;
+}
+
+/**
+ * @brief Evaluates the expression on random assignments
+ * @param samples Number of assignments to draw
+ * @return SampleResult Counts, confidence interval and example rows
+ */
+SampleResult Sampler::run(size_t samples) {
+    SampleResult result;
+    result.samples = samples;
+
+    const size_t variableCount = compiled.getVariables().size();
+    size_t blockWords = std::max<size_t>(1, std::min(kMaxBlockWords,
+                                                     kBlockWordBudget / std::max<size_t>(1, variableCount)));
+    std::vector<std::vector<uint64_t>> columns(variableCount, std::vector<uint64_t>(blockWords));
+    std::vector<const uint64_t*> inputs;
+    for (const auto& column : columns) {
+        inputs.push_back(column.data());
+    }
+    std::vector<uint64_t> scratch;
+
+    for (size_t done = 0; done < samples; ) {
+        size_t rows = std::min(samples - done, blockWords * 64);
+        size_t numWords = (rows + 63) / 64;
+        for (auto& column : columns) {
+            fill(column.data(), numWords);
+        }
+
+        std::vector<uint64_t> values = compiled.evaluateColumns(output, inputs, rows, scratch);
+        for (size_t word = 0; word < numWords; ++word) {
+            uint64_t trueBits = values[word];
+            uint64_t falseBits = ~trueBits & rowMask(rows, word);
+            result.trueCount += std::bitset<64>(trueBits).count();
+
+            // Keep the first assignment of each kind as an example
+            if (!result.foundSatisfying && trueBits) {
+                size_t bit = lowestBit(trueBits);
+                for (const auto& column : columns) {
+                    result.satisfyingRow.push_back((column[word] >> bit) & 1);
+                }
+                result.foundSatisfying = true;
+            }
+            if (!result.foundFalsifying && falseBits) {
+                size_t bit = lowestBit(falseBits);
+                for (const auto& column : columns) {
+                    result.falsifyingRow.push_back((column[word] >> bit) & 1);
+                }
+                result.foundFalsifying = true;
+            }
+        }
+        done += rows;
+    }
+
+    // Wilson score interval; unlike the normal approximation it stays inside
+    // [0, 1] and is meaningful when no or all samples are true
+    if (samples > 0) {
+        double n = static_cast<double>(samples);
+        double p = result.trueCount / n;
+        double z2 = kConfidenceZ * kConfidenceZ;
+        double denominator = 1 + z2 / n;
+        double center = (p + z2 / (2 * n)) / denominator;
+        double half = kConfidenceZ * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / denominator;
+        result.low = std::max(0.0, center - half);
+        result.high = std::min(1.0, center + half);
+    }
+    return result;
+}
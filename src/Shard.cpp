@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "../include/Shard.h"
+
+/**
+ * @brief Checks whether this machine stores words little-endian, as shard files do
+ * @return bool True when words can be copied to and from the file unchanged
+ */
+static bool littleEndianHost() {
+    const uint32_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+/**
+ * @brief Reverses the bytes of a word, converting between little- and big-endian
+ * @param word The word to convert
+ * @return uint64_t The word with its bytes in the opposite order
+ */
+static uint64_t swapBytes(uint64_t word) {
+    uint64_t swapped = 0;
+    for (int i = 0; i < 8; ++i) {
+        swapped = (swapped << 8) | ((word >> (8 * i)) & 0xff);
+    }
+    return swapped;
+}
+
+/**
+ * @brief Evaluates one shard of a formula's result column
+ * @param dag Compiled DAG holding the formula, with its variables sorted and its outputs labelled
+ * @param output Index of the formula in the DAG
+ * @param position Position of the formula in the input, from 0
+ * @param index Shard number, from 0 to count - 1
+ * @param count Number of shards
+ * @return ShardSection The evaluated slice
+ */
+ShardSection computeShard(const BatchEvaluator& dag, size_t output, size_t position,
+                          size_t index, size_t count) {
+    ShardSection section;
+    section.position = position;
+    section.variables = dag.getVariables();
+    if (section.variables.size() >= 64) {
+        throw std::runtime_error("Too many variables for a full truth table: " +
+                                 std::to_string(section.variables.size()));
+    }
+    section.formula = dag.getLabels()[output];
+    section.rows = size_t(1) << section.variables.size();
+    section.index = index;
+    section.count = count;
+
+    // Contiguous ranges whose sizes differ by at most one word; the first
+    // `extra` shards take one more. Split without multiplying by totalWords,
+    // which could overflow for the largest tables.
+    size_t totalWords = (section.rows + 63) / 64;
+    size_t perShard = totalWords / count;
+    size_t extra = totalWords % count;
+    section.firstWord = perShard * index + std::min(index, extra);
+    section.numWords = perShard + (index < extra ? 1 : 0);
+
+    std::vector<uint64_t> scratch;
+    section.words = dag.evaluateRange(output, section.firstWord, section.numWords, scratch);
+    for (uint64_t word : section.words) {
+        section.trueCount += std::bitset<64>(word).count();
+    }
+    return section;
+}
+
+/**
+ * @brief Writes a shard section in the self-describing shard format
+ * @param out Binary output stream
+ * @param section The section to write
+ */
+void writeShard(std::ostream& out, const ShardSection& section) {
+    out << "LOGIC-SHARD 2\n";
+    out << "position: " << section.position << "\n";
+    out << "formula: " << section.formula << "\n";
+    out << "variables:";
+    for (const auto& var : section.variables) out << " " << var;
+    out << "\n";
+    out << "rows: " << section.rows << "\n";
+    out << "shard: " << section.index << "/" << section.count << "\n";
+    out << "first_word: " << section.firstWord << "\n";
+    out << "words: " << section.numWords << "\n";
+    out << "true_count: " << section.trueCount << "\n";
+    out << "data:\n";
+    if (littleEndianHost()) {
+        out.write(reinterpret_cast<const char*>(section.words.data()),
+                  section.words.size() * sizeof(uint64_t));
+    } else {
+        std::vector<uint64_t> words(section.words.size());
+        std::transform(section.words.begin(), section.words.end(), words.begin(), swapBytes);
+        out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+    }
+    out << "\n";
+}
+
+/**
+ * @brief Reads the value of a "key: value" header line
+ * @param in Stream positioned at the header line
+ * @param key The expected key
+ * @param path File name for error messages
+ * @return std::string The value after "key: " (or after "key:" if the value is empty)
+ */
+static std::string readField(std::istream& in, const std::string& key, const std::string& path) {
+    std::string line;
+    if (!std::getline(in, line) || line.compare(0, key.length() + 1, key + ":") != 0) {
+        throw std::runtime_error("Malformed shard file " + path + ": expected '" + key + ":'");
+    }
+    size_t start = key.length() + 1;
+    if (start < line.length() && line[start] == ' ') ++start;
+    return line.substr(start);
+}
+
+/**
+ * @brief Reads every section of a shard file
+ * @param path Path of the shard file
+ * @param withData False to skip the packed words when only counts are needed
+ * @return std::vector<ShardSection> The sections in file order
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+std::vector<ShardSection> readShards(const std::string& path, bool withData) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not open shard file: " + path);
+    }
+
+    std::vector<ShardSection> sections;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        if (line == "LOGIC-SHARD 1") {
+            throw std::runtime_error("Shard file " + path + " was written by an older version; "
+                                     "rerun its worker");
+        }
+        if (line != "LOGIC-SHARD 2") {
+            throw std::runtime_error("Malformed shard file " + path + ": unknown section '" + line + "'");
+        }
+
+        ShardSection section;
+        try {
+            section.position = std::stoull(readField(in, "position", path));
+            section.formula = readField(in, "formula", path);
+            std::istringstream variables(readField(in, "variables", path));
+            std::string var;
+            while (variables >> var) section.variables.push_back(var);
+            section.rows = std::stoull(readField(in, "rows", path));
+            std::string shard = readField(in, "shard", path);
+            section.index = std::stoull(shard.substr(0, shard.find('/')));
+            section.count = std::stoull(shard.substr(shard.find('/') + 1));
+            section.firstWord = std::stoull(readField(in, "first_word", path));
+            section.numWords = std::stoull(readField(in, "words", path));
+            section.trueCount = std::stoull(readField(in, "true_count", path));
+            readField(in, "data", path);
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("Malformed shard file " + path + ": invalid number");
+        }
+
+        if (withData) {
+            section.words.resize(section.numWords);
+            in.read(reinterpret_cast<char*>(section.words.data()), section.numWords * sizeof(uint64_t));
+            if (!littleEndianHost()) {
+                std::transform(section.words.begin(), section.words.end(), section.words.begin(), swapBytes);
+            }
+        } else {
+            in.seekg(section.numWords * sizeof(uint64_t), std::ios::cur);
+        }
+        if (!in) {
+            throw std::runtime_error("Malformed shard file " + path + ": truncated data");
+        }
+        sections.push_back(std::move(section));
+    }
+
+    return sections;
+}
+
+/**
+ * @brief Combines shard sections into one section per formula
+ * @param sections Sections from any number of shard files, in any order
+ * @return std::vector<ShardSection> One full-table section per formula, in input order
+ * @throws std::runtime_error if a formula's shards overlap, disagree or leave gaps
+ */
+std::vector<ShardSection> mergeShards(const std::vector<ShardSection>& sections) {
+    // Group by input position, so repeated formulas stay separate tables
+    std::map<size_t, std::vector<const ShardSection*>> groups;
+    for (const auto& section : sections) {
+        groups[section.position].push_back(&section);
+    }
+
+    std::vector<ShardSection> merged;
+    for (auto& [position, group] : groups) {
+        std::sort(group.begin(), group.end(), [](const ShardSection* a, const ShardSection* b) {
+            return a->index < b->index;
+        });
+
+        const ShardSection& first = *group.front();
+        ShardSection result;
+        result.position = position;
+        result.formula = first.formula;
+        result.variables = first.variables;
+        result.rows = first.rows;
+        result.numWords = (first.rows + 63) / 64;
+
+        // Shards must tile the word range exactly, with no gaps or overlaps
+        size_t nextWord = 0;
+        for (size_t i = 0; i < group.size(); ++i) {
+            const ShardSection* section = group[i];
+            if (i > 0 && section->index == group[i - 1]->index) {
+                throw std::runtime_error("Shard " + std::to_string(section->index) + " of '" +
+                                         first.formula + "' appears more than once");
+            }
+            if (section->formula != first.formula) {
+                throw std::runtime_error("Shards disagree on formula " + std::to_string(position + 1) +
+                                         ": '" + first.formula + "' and '" + section->formula + "'");
+            }
+            if (section->variables != first.variables || section->rows != first.rows ||
+                section->count != first.count) {
+                throw std::runtime_error("Shards of '" + first.formula + "' disagree on the table layout");
+            }
+            if (section->firstWord != nextWord) {
+                throw std::runtime_error("Shards of '" + first.formula + "' " +
+                                         (section->firstWord < nextWord ? "overlap" : "leave a gap") +
+                                         " at word " + std::to_string(std::min(nextWord, section->firstWord)));
+            }
+            nextWord += section->numWords;
+            result.trueCount += section->trueCount;
+            result.words.insert(result.words.end(), section->words.begin(), section->words.end());
+        }
+        if (nextWord != result.numWords || group.size() != first.count) {
+            throw std::runtime_error("Shards of '" + first.formula + "' are incomplete: " +
+                                     std::to_string(group.size()) + " of " +
+                                     std::to_string(first.count) + " present");
+        }
+
+        merged.push_back(std::move(result));
+    }
+
+    return merged;
+}
@@ -0,0 +1,801 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/Scanner.h"
+#include "../include/Parser.h"
+#include "../include/Evaluator.h"
+#include "../include/BatchEvaluator.h"
+#include "../include/FormulaImporter.h"
+#include "../include/Shard.h"
+#include "../include/Minimizer.h"
+#include "../include/AssignmentReader.h"
+#include "../include/ChunkedTable.h"
+#include "../include/OutputWriter.h"
+#include "../include/FormulaLibrary.h"
+#include "../include/Sampler.h"
+#include "../include/Checker.h"
+
+static int failures = 0;
+
+static Node* parse(const std::string& formula) {
+    Scanner scanner(formula);
+    std::vector<Token> tokens = scanner.getTokens();
+    Parser parser(tokens);
+    return parser.parseSentence();
+}
+
+// Check the packed table of a formula against the row-by-row reference table
+static void expectMatchesReference(const std::string& formula, ColumnCache* cache) {
+    std::unique_ptr<Node> root(parse(formula));
+    try {
+        auto reference = Evaluator(root.get()).generateTruthTable();
+        TruthColumns table = Evaluator(root.get()).generateTruthColumns(cache);
+
+        if (table.labels != reference.second || table.numRows != reference.first.size()) {
+            std::cout << "FAIL: " << formula << ": column labels differ" << std::endl;
+            ++failures;
+            return;
+        }
+        for (size_t row = 0; row < table.numRows; ++row) {
+            const auto& values = reference.first[row].first;
+            const auto& results = reference.first[row].second;
+            for (size_t column = 0; column < table.labels.size(); ++column) {
+                const std::string& label = table.labels[column];
+                bool expected = values.count(label) ? values.at(label) : results.at(label);
+                if (table.get(column, row) != expected) {
+                    std::cout << "FAIL: " << formula << ": column '" << label
+                              << "' differs at row " << row << std::endl;
+                    ++failures;
+                    return;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: " << formula << ": " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check that a selected column matches the same column of the full table
+static void expectSelectedMatchesTable(const std::string& formula, const std::string& label) {
+    std::unique_ptr<Node> root(parse(formula));
+    try {
+        TruthColumns table = Evaluator(root.get()).generateTruthColumns();
+        TruthColumns selected = Evaluator(root.get()).generateSelectedColumns({label});
+
+        size_t column = 0;
+        while (column < table.labels.size() && table.labels[column] != label) ++column;
+        if (column == table.labels.size() || selected.columns.back() != table.columns[column]) {
+            std::cout << "FAIL: " << formula << ": selected column '" << label
+                      << "' differs from the full table" << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: " << formula << ": " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check the column labels produced for a --columns selection
+static void expectSelectedLabels(const std::string& formula, const std::vector<std::string>& selected,
+                                 const std::vector<std::string>& expected) {
+    std::unique_ptr<Node> root(parse(formula));
+    try {
+        TruthColumns table = Evaluator(root.get()).generateSelectedColumns(selected);
+        if (table.labels != expected || table.columns.size() != expected.size()) {
+            std::cout << "FAIL: " << formula << ": unexpected selected columns" << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: " << formula << ": " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Import every formula of a file into one DAG with its variables sorted
+static BatchEvaluator importText(const std::string& text) {
+    std::istringstream input(text);
+    FormulaImporter importer(input);
+    BatchEvaluator dag;
+    while (importer.next(dag)) {
+    }
+    dag.sortVariables();
+    return dag;
+}
+
+// Rename the variables of a parse tree, since the scanner only knows P and Q
+static void renameVariables(Node* node, const std::string& p, const std::string& q) {
+    if (node->value == "P") node->value = p;
+    if (node->value == "Q") node->value = q;
+    for (Node* child : node->children) {
+        renameVariables(child, p, q);
+    }
+}
+
+// Check an imported formula against the table of the same formula parsed by Parser,
+// with P and Q renamed to the names the import uses
+static void expectImportMatchesParser(const std::string& text, const std::string& formula,
+                                      const std::string& p = "P", const std::string& q = "Q") {
+    std::unique_ptr<Node> root(parse(formula));
+    renameVariables(root.get(), p, q);
+    try {
+        BatchEvaluator dag = importText(text);
+        TruthColumns imported = dag.evaluate();
+        TruthColumns reference = Evaluator(root.get()).generateTruthColumns();
+
+        const std::vector<std::string>& variables = dag.getVariables();
+        if (dag.getOutputs().size() != 1 || reference.labels.size() < variables.size() ||
+            !std::equal(variables.begin(), variables.end(), reference.labels.begin()) ||
+            imported.numRows != reference.numRows) {
+            std::cout << "FAIL: import of " << formula << ": variables differ" << std::endl;
+            ++failures;
+            return;
+        }
+        for (size_t row = 0; row < reference.numRows; ++row) {
+            if (imported.get(imported.columns.size() - 1, row) !=
+                reference.get(reference.columns.size() - 1, row)) {
+                std::cout << "FAIL: import of " << formula << ": result differs at row " << row << std::endl;
+                ++failures;
+                return;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: import of " << formula << ": " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check that importing malformed input fails with the given message
+static void expectImportError(const std::string& text, const std::string& message) {
+    try {
+        importText(text);
+        std::cout << "FAIL: import of '" << text << "' did not fail" << std::endl;
+        ++failures;
+    } catch (const std::exception& e) {
+        if (std::string(e.what()) != message) {
+            std::cout << "FAIL: import of '" << text << "': expected '" << message
+                      << "', got '" << e.what() << "'" << std::endl;
+            ++failures;
+        }
+    }
+}
+
+static size_t treeDepth(const Node* node) {
+    size_t depth = 0;
+    for (const Node* child : node->children) {
+        depth = std::max(depth, treeDepth(child));
+    }
+    return depth + 1;
+}
+
+// Check that a long run of one operator is imported as a shallow tree
+static void expectBalancedRun(size_t operands) {
+    std::string text = "P0";
+    for (size_t i = 1; i < operands; ++i) {
+        text += " AND P" + std::to_string(i);
+    }
+    try {
+        BatchEvaluator dag = importText(text);
+        std::unique_ptr<Node> tree(dag.toTree(dag.getOutputs()[0]));
+        size_t limit = 2;
+        while ((size_t(1) << (limit - 2)) < operands) ++limit;
+        if (treeDepth(tree.get()) > limit || dag.getVariables().size() != operands) {
+            std::cout << "FAIL: run of " << operands << " ANDs is not balanced" << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: run of " << operands << " ANDs: " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Import formulas for the shard tests, labelled as computeShard expects
+static BatchEvaluator labelledDag(const std::string& text) {
+    BatchEvaluator dag = importText(text);
+    dag.labelOutputs();
+    return dag;
+}
+
+// Check that shards of every size tile the table and merge back in any order
+static void expectShardsMerge(const std::string& text, size_t count) {
+    try {
+        BatchEvaluator dag = labelledDag(text);
+        TruthColumns table = dag.evaluate();
+        size_t formulas = dag.getOutputs().size();
+
+        // Sections arrive newest shard first and interleaved across formulas
+        std::vector<ShardSection> sections;
+        for (size_t index = count; index-- > 0;) {
+            for (size_t output = formulas; output-- > 0;) {
+                sections.push_back(computeShard(dag, output, output, index, count));
+            }
+        }
+
+        std::vector<ShardSection> merged = mergeShards(sections);
+        bool same = merged.size() == formulas;
+        for (size_t output = 0; same && output < formulas; ++output) {
+            size_t column = dag.getVariables().size() + output;
+            size_t trueCount = 0;
+            for (size_t row = 0; row < table.numRows; ++row) trueCount += table.get(column, row);
+            same = merged[output].position == output && merged[output].words == table.columns[column] &&
+                   merged[output].trueCount == trueCount;
+        }
+        if (!same) {
+            std::cout << "FAIL: " << count << " shard(s) do not merge to the full table" << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: " << count << " shard(s): " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check that merging the sections fails with a message containing the given text
+static void expectMergeError(const std::vector<ShardSection>& sections, const std::string& message) {
+    try {
+        mergeShards(sections);
+        std::cout << "FAIL: merge did not report '" << message << "'" << std::endl;
+        ++failures;
+    } catch (const std::exception& e) {
+        if (std::string(e.what()).find(message) == std::string::npos) {
+            std::cout << "FAIL: expected merge error '" << message << "', got '" << e.what() << "'"
+                      << std::endl;
+            ++failures;
+        }
+    }
+}
+
+// Check that a shard file written by writeShard reads back unchanged, and that bad files are rejected
+static void expectShardFileRoundTrip() {
+    std::string path = (std::filesystem::temp_directory_path() / "logic_tests_shard.bin").string();
+    try {
+        BatchEvaluator dag = labelledDag("A AND B OR C AND NOT D OR E AND F OR G AND H");
+        ShardSection section = computeShard(dag, 0, 3, 1, 3);
+        {
+            std::ofstream out(path, std::ios::binary);
+            writeShard(out, section);
+            writeShard(out, section);
+        }
+        std::vector<ShardSection> read = readShards(path, true);
+        if (read.size() != 2 || read[1].words != section.words || read[1].position != 3 ||
+            read[1].formula != section.formula || read[1].variables != section.variables ||
+            read[1].firstWord != section.firstWord || read[1].trueCount != section.trueCount) {
+            std::cout << "FAIL: shard file does not read back as written" << std::endl;
+            ++failures;
+        }
+
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+        try {
+            readShards(path, true);
+            std::cout << "FAIL: truncated shard file was accepted" << std::endl;
+            ++failures;
+        } catch (const std::runtime_error&) {
+        }
+
+        std::ofstream(path, std::ios::binary) << "LOGIC-SHARD 1\n";
+        try {
+            readShards(path, true);
+            std::cout << "FAIL: shard file of an older version was accepted" << std::endl;
+            ++failures;
+        } catch (const std::runtime_error&) {
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: shard file round trip: " << e.what() << std::endl;
+        ++failures;
+    }
+    std::remove(path.c_str());
+}
+
+// Pack a function of the row index into a result column, variable j being bit j
+static std::vector<uint64_t> packColumn(size_t numVariables, const std::function<bool(size_t)>& function) {
+    size_t numRows = size_t(1) << numVariables;
+    std::vector<uint64_t> column((numRows + 63) / 64, 0);
+    for (size_t row = 0; row < numRows; ++row) {
+        if (function(row)) column[row / 64] |= uint64_t(1) << (row % 64);
+    }
+    return column;
+}
+
+// Check that a minimized form has the same truth table as the column it came from
+static bool sameFunction(const std::string& form, const std::vector<std::string>& variables,
+                         const std::vector<uint64_t>& column) {
+    // Every variable is added first, so ones the form leaves out still get their column
+    BatchEvaluator dag;
+    for (const auto& name : variables) dag.addVariable(name);
+    std::istringstream input(form);
+    FormulaImporter importer(input);
+    importer.next(dag);
+    dag.sortVariables();
+
+    TruthColumns table = dag.evaluate();
+    for (size_t row = 0; row < table.numRows; ++row) {
+        if (table.get(table.columns.size() - 1, row) != (((column[row / 64] >> (row % 64)) & 1) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check both minimized forms of a function against it and against the expected exactness
+static void expectMinimized(const std::string& name, size_t numVariables,
+                            const std::function<bool(size_t)>& function, bool expectExact) {
+    std::vector<std::string> variables;
+    for (size_t j = 0; j < numVariables; ++j) {
+        variables.push_back(std::string(1, char('A' + j)));
+    }
+    std::vector<uint64_t> column = packColumn(numVariables, function);
+    try {
+        Minimizer minimizer(variables, column);
+        bool sopExact;
+        bool posExact;
+        std::string sop = minimizer.minimalSOP(sopExact);
+        std::string pos = minimizer.minimalPOS(posExact);
+        if (!sameFunction(sop, variables, column) || !sameFunction(pos, variables, column)) {
+            std::cout << "FAIL: minimized forms of " << name << " are not equivalent to it" << std::endl;
+            ++failures;
+        }
+        if (sopExact != expectExact || posExact != expectExact) {
+            std::cout << "FAIL: minimized forms of " << name << " should be "
+                      << (expectExact ? "exact" : "labelled near-minimal") << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: minimizing " << name << ": " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check that an assignment stream is read in blocks with the expected rows
+static void expectAssignments(const std::string& text, const std::vector<std::string>& variables,
+                              const std::vector<std::vector<bool>>& rows, size_t blockRows) {
+    try {
+        std::istringstream input(text);
+        AssignmentReader reader(input);
+        bool same = reader.getVariables() == variables;
+
+        std::vector<std::vector<uint64_t>> columns;
+        size_t read = 0;
+        size_t count;
+        while (same && (count = reader.readBlock(columns, blockRows)) > 0) {
+            for (size_t row = 0; same && row < count; ++row) {
+                same = read + row < rows.size();
+                for (size_t j = 0; same && j < variables.size(); ++j) {
+                    same = (((columns[j][row / 64] >> (row % 64)) & 1) != 0) == rows[read + row][j];
+                }
+            }
+            read += count;
+        }
+        if (!same || read != rows.size()) {
+            std::cout << "FAIL: assignments were not read as written" << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: reading assignments: " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check that reading an assignment stream fails with the given message
+static void expectAssignmentError(const std::string& text, const std::string& message) {
+    try {
+        std::istringstream input(text);
+        AssignmentReader reader(input);
+        std::vector<std::vector<uint64_t>> columns;
+        while (reader.readBlock(columns, 64) > 0) {
+        }
+        std::cout << "FAIL: assignments '" << text << "' were accepted" << std::endl;
+        ++failures;
+    } catch (const std::exception& e) {
+        if (std::string(e.what()) != message) {
+            std::cout << "FAIL: expected '" << message << "', got '" << e.what() << "'" << std::endl;
+            ++failures;
+        }
+    }
+}
+
+// Read a whole file into a string
+static std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+// Check that a spilled table matches the in-memory table, resumes missing chunks
+// and starts over when the manifest of the directory belongs to another formula
+static void expectSpillResumes() {
+    namespace fs = std::filesystem;
+    fs::path directory = fs::temp_directory_path() / "logic_tests_spill";
+    fs::remove_all(directory);
+    try {
+        BatchEvaluator dag = importText("A AND B OR C AND NOT D OR E AND F OR G AND H;\nA OR H");
+        std::unique_ptr<Node> tree(dag.toTree(dag.getOutputs()[0]));
+        std::unique_ptr<Node> other(dag.toTree(dag.getOutputs()[1]));
+        Evaluator evaluator(tree.get());
+
+        // A budget of one word per column gives one 64-row chunk per word
+        size_t budget = evaluator.countColumns() * sizeof(uint64_t);
+        std::ostringstream log;
+        ChunkedTableWriter(directory.string(), budget).write(evaluator, log);
+
+        TruthColumns table = Evaluator(tree.get()).generateTruthColumns();
+        std::string expected;
+        for (size_t chunk = 0; chunk < 4; ++chunk) {
+            for (size_t column = 8; column < table.columns.size(); ++column) {
+                const uint64_t& word = table.columns[column][chunk];
+                expected.append(reinterpret_cast<const char*>(&word), sizeof(uint64_t));
+            }
+        }
+        std::string written;
+        for (size_t chunk = 0; chunk < 4; ++chunk) {
+            written += readFile(directory / ("chunk_00000" + std::to_string(chunk) + ".bin"));
+        }
+        if (written != expected || log.str().find("4 chunk(s) of 64 rows") == std::string::npos) {
+            std::cout << "FAIL: spilled chunks differ from the in-memory table" << std::endl;
+            ++failures;
+        }
+
+        // A rerun keeps the finished chunks and rewrites only the missing one
+        fs::remove(directory / "chunk_000002.bin");
+        std::ostringstream resumed;
+        ChunkedTableWriter(directory.string(), budget).write(evaluator, resumed);
+        size_t chunkBytes = written.size() / 4;
+        if (resumed.str().find("(3 resumed)") == std::string::npos ||
+            readFile(directory / "chunk_000002.bin") != written.substr(2 * chunkBytes, chunkBytes)) {
+            std::cout << "FAIL: spill did not resume from the missing chunk: " << resumed.str();
+            ++failures;
+        }
+
+        // Another formula in the same directory must not reuse any chunk
+        Evaluator otherEvaluator(other.get());
+        std::ostringstream replaced;
+        ChunkedTableWriter(directory.string(), budget).write(otherEvaluator, replaced);
+        if (replaced.str().find("resumed") != std::string::npos ||
+            readFile(directory / "manifest.txt").find("formula: A OR H") == std::string::npos) {
+            std::cout << "FAIL: spill reused chunks of a different manifest: " << replaced.str();
+            ++failures;
+        }
+
+        try {
+            ChunkedTableWriter(directory.string(), budget - 1).write(evaluator, log);
+            std::cout << "FAIL: spill accepted a budget below one word per column" << std::endl;
+            ++failures;
+        } catch (const std::runtime_error&) {
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: spill: " << e.what() << std::endl;
+        ++failures;
+    }
+    fs::remove_all(directory);
+}
+
+// Check that output handed to the writer thread reaches the file complete and in order,
+// with blocks far smaller than the writes so the queue fills and drains repeatedly
+static void expectWriterKeepsOrder() {
+    std::FILE* file = std::tmpfile();
+    if (!file) return;
+    std::string expected;
+    {
+        OutputWriter writer(file, 16, 1);
+        for (size_t line = 0; line < 2000; ++line) {
+            std::string text = "line " + std::to_string(line) + "\n";
+            writer.write(text);
+            expected += text;
+        }
+        writer.flush();
+        writer.write("tail");
+        expected += "tail";
+    }
+
+    std::string written(expected.size() + 1, '\0');
+    std::rewind(file);
+    written.resize(std::fread(&written[0], 1, written.size(), file));
+    std::fclose(file);
+    if (written != expected) {
+        std::cout << "FAIL: output writer lost or reordered output" << std::endl;
+        ++failures;
+    }
+}
+
+// Overwrite part of a file in place
+static void patchFile(const std::string& path, size_t offset, const void* bytes, size_t size) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(static_cast<const char*>(bytes), size);
+}
+
+// Check that loading a library fails with a message starting with the given text
+static void expectLibraryError(const std::string& path, const std::string& message) {
+    try {
+        FormulaLibrary library(path);
+        std::cout << "FAIL: damaged library was loaded, expected '" << message << "'" << std::endl;
+        ++failures;
+    } catch (const std::exception& e) {
+        if (std::string(e.what()).compare(0, message.size(), message) != 0) {
+            std::cout << "FAIL: expected library error '" << message << "', got '" << e.what() << "'"
+                      << std::endl;
+            ++failures;
+        }
+    }
+}
+
+// Check that a library evaluates like its DAG and that damaged headers and nodes are rejected
+static void expectLibraryValidated() {
+    std::string path = (std::filesystem::temp_directory_path() / "logic_tests.lib").string();
+    try {
+        BatchEvaluator dag = labelledDag("A AND B OR NOT C;\nA EQUIVALENT D;\nA AND B OR NOT C");
+        FormulaLibrary::write(dag, path);
+        TruthColumns expected = dag.evaluate();
+        TruthColumns loaded = FormulaLibrary(path).evaluate();
+        if (loaded.labels != expected.labels || loaded.columns != expected.columns) {
+            std::cout << "FAIL: library evaluates differently from its DAG" << std::endl;
+            ++failures;
+        }
+
+        // Header: 8-byte magic, then the version and byte order words
+        const uint32_t badVersion = FormulaLibrary::kVersion + 1;
+        const uint32_t swappedOrder = 0x04030201;
+        const uint32_t badOperand = 1000;
+        size_t node = 0;
+        while (dag.getNodes()[node].op != BatchEvaluator::Op::AND) ++node;
+
+        FormulaLibrary::write(dag, path);
+        patchFile(path, 0, "LOGICLIX", 8);
+        expectLibraryError(path, "Not a formula library");
+        FormulaLibrary::write(dag, path);
+        patchFile(path, 8, &badVersion, sizeof(badVersion));
+        expectLibraryError(path, "Unsupported library version");
+        FormulaLibrary::write(dag, path);
+        patchFile(path, 12, &swappedOrder, sizeof(swappedOrder));
+        expectLibraryError(path, "Library was compiled on a machine with a different byte order");
+        FormulaLibrary::write(dag, path);
+        patchFile(path, 32 + node * sizeof(BatchEvaluator::DagNode) + 4, &badOperand, sizeof(badOperand));
+        expectLibraryError(path, "Library file has an invalid node");
+        FormulaLibrary::write(dag, path);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        expectLibraryError(path, "Library file has the wrong size");
+        std::filesystem::resize_file(path, 16);
+        expectLibraryError(path, "Library file is truncated");
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: library: " << e.what() << std::endl;
+        ++failures;
+    }
+    std::remove(path.c_str());
+}
+
+// Check that equal seeds reproduce a sampling run exactly and that the estimate is plausible
+static void expectSamplesReproducible() {
+    try {
+        // A OR B OR C OR D is true on 15 of 16 rows
+        BatchEvaluator dag = importText("A OR B OR C OR D;\nA OR NOT A");
+        SampleResult first = Sampler(dag, 0, 42).run(10000);
+        SampleResult again = Sampler(dag, 0, 42).run(10000);
+        SampleResult other = Sampler(dag, 0, 43).run(10000);
+        SampleResult always = Sampler(dag, 1, 42).run(1000);
+
+        if (first.trueCount != again.trueCount || first.satisfyingRow != again.satisfyingRow ||
+            first.falsifyingRow != again.falsifyingRow || first.low != again.low ||
+            first.high != again.high) {
+            std::cout << "FAIL: sampling with the same seed gave different results" << std::endl;
+            ++failures;
+        }
+        if (first.samples != 10000 || first.low > 15.0 / 16 || first.high < 15.0 / 16 ||
+            other.low > 15.0 / 16 || other.high < 15.0 / 16 || !first.foundFalsifying ||
+            first.falsifyingRow != std::vector<bool>(4, false)) {
+            std::cout << "FAIL: sampled fraction of A OR B OR C OR D is implausible" << std::endl;
+            ++failures;
+        }
+        if (always.trueCount != always.samples || always.foundFalsifying) {
+            std::cout << "FAIL: sampling a tautology found a false row" << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: sampling: " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Check that the parallel checker reports the lowest row with the given value, found by brute force
+static void expectLowestRow(const std::string& text, bool value,
+                            const std::function<bool(size_t)>& function) {
+    try {
+        BatchEvaluator dag = importText(text);
+        size_t numRows = size_t(1) << dag.getVariables().size();
+        size_t expected = 0;
+        while (expected < numRows && function(expected) != value) ++expected;
+
+        // Several threads, whatever the machine, so blocks finish out of order
+        Checker checker(dag, 0, 4);
+        size_t row = 0;
+        bool found = checker.findRow(value, row);
+        if (found != (expected < numRows) || (found && row != expected)) {
+            std::cout << "FAIL: checker found " << (found ? "row " + std::to_string(row) : "no row")
+                      << " of " << text << ", expected " << expected << std::endl;
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: checking " << text << ": " << e.what() << std::endl;
+        ++failures;
+    }
+}
+
+int main() {
+    // NOT (P AND Q) and (NOT P) AND Q both print as "NOT P AND Q"
+    expectMatchesReference("NOT (P AND Q) OR (NOT P AND Q)", nullptr);
+    expectMatchesReference("(NOT P AND Q) OR NOT (P AND Q)", nullptr);
+
+    // The same pair through a cache shared between inputs, as in interactive mode
+    ColumnCache cache;
+    expectMatchesReference("NOT (P AND Q)", &cache);
+    expectMatchesReference("NOT P AND Q", &cache);
+    expectMatchesReference("NOT (P AND Q) OR (NOT P AND Q)", &cache);
+
+    expectSelectedMatchesTable("NOT (P AND Q) OR (NOT P AND Q)", "NOT P AND Q");
+    expectSelectedMatchesTable("(NOT P AND Q) OR NOT (P AND Q)", "NOT P AND Q");
+
+    // Variables and repeated labels are not shown twice
+    expectSelectedLabels("P AND Q", {"P AND Q", "P", "P AND Q"}, {"P", "Q", "P AND Q"});
+
+    // Imported infix formulas, with runs rebalanced and comments and line breaks skipped
+    expectImportMatchesParser("(P AND\n  Q) OR NOT NOT P # comment\n", "(P AND Q) OR NOT NOT P");
+    expectImportMatchesParser("P AND NOT Q AND P AND Q AND P", "P AND NOT Q AND P AND Q AND P");
+    expectImportMatchesParser("P OR Q OR NOT P OR NOT Q", "P OR Q OR NOT P OR NOT Q");
+    expectImportMatchesParser("P EQUIVALENT Q EQUIVALENT P EQUIVALENT NOT Q",
+                              "P EQUIVALENT Q EQUIVALENT P EQUIVALENT NOT Q");
+    expectImportMatchesParser("P IMPLIES Q IMPLIES P;", "P IMPLIES Q IMPLIES P");
+    expectImportMatchesParser("P AND Q OR P IMPLIES Q EQUIVALENT P", "P AND Q OR P IMPLIES Q EQUIVALENT P");
+    expectImportMatchesParser("TRUE AND P OR FALSE OR NOT TRUE", "TRUE AND P OR FALSE OR NOT TRUE");
+    expectBalancedRun(1000);
+    if (importText("P AND Q;\n;\nNOT P;").getOutputs().size() != 2) {
+        std::cout << "FAIL: two ';'-terminated formulas were not imported as two outputs" << std::endl;
+        ++failures;
+    }
+
+    // Imported DIMACS files, including a clause across lines and a final clause without 0
+    expectImportMatchesParser("c example\np cnf 2 3\n1 -2 0\n2 1 0\n-1 0\n",
+                              "(P OR NOT Q) AND (Q OR P) AND NOT P", "X1", "X2");
+    expectImportMatchesParser("p cnf 2 2\n1\n 2 0 -2", "(P OR Q) AND NOT Q", "X1", "X2");
+    expectImportMatchesParser("p cnf 2 2\n1 -2 0\n0\n", "(P OR NOT Q) AND FALSE", "X1", "X2");
+    if (importText("p cnf 12 1\n2 012 0\n").getVariables() != std::vector<std::string>{"X02", "X12"}) {
+        std::cout << "FAIL: DIMACS variables are not zero-padded to the declared count" << std::endl;
+        ++failures;
+    }
+
+    // Malformed input is reported with its line number
+    expectImportError("P AND\nQ AND\n(R", "Line 3: Missing closing parenthesis");
+    expectImportError("P AND Q OR", "Line 1: Missing right operand after 'OR'");
+    expectImportError("P AND Q)", "Line 1: Unmatched ')'");
+    expectImportError("P AND\n\n  q", "Line 3: Invalid token: 'q'");
+    expectImportError("p cnf 99999999999999999999999 1\n", "Line 1: Count in 'p cnf' header is too large");
+    expectImportError("p cnf 2 1\n\n99999999999999999999999 0\n", "Line 3: Literal is too large");
+    expectImportError("p cnf 2 1\n1 3 0\n", "Line 2: Variable 3 exceeds the declared 2");
+    expectImportError("p cnf 2 1\n1 -0\n", "Line 2: Invalid literal '-0'");
+    expectImportError("p cnf 2 1\n1 2x 0\n", "Line 2: Invalid literal in clause");
+    expectImportError("c only\n1 2 0\n", "Line 2: Clause before the 'p cnf' header");
+    expectImportError("p cnf 2 3\n1 0\n2 0\n", "Line 3: Read 2 clause(s), but the 'p cnf' header declares 3");
+
+    // Shards tile the table for any count, including more shards than words
+    // A repeated formula keeps one merged table per position
+    const std::string shardFormulas = "A AND B OR C AND NOT D OR E AND F OR G AND H;\n"
+                                      "A AND B OR C AND NOT D OR E AND F OR G AND H;\n"
+                                      "A EQUIVALENT H";
+    for (size_t count : {1, 2, 3, 4, 7}) {
+        expectShardsMerge(shardFormulas, count);
+    }
+    expectShardFileRoundTrip();
+
+    // Incomplete, repeated, overlapping or disagreeing shards are rejected
+    {
+        BatchEvaluator dag = labelledDag("A AND B OR C AND NOT D OR E AND F OR G AND H;\nA OR B");
+        std::vector<ShardSection> shards;
+        for (size_t index = 0; index < 3; ++index) shards.push_back(computeShard(dag, 0, 0, index, 3));
+
+        expectMergeError({shards[0], shards[2]}, "leave a gap");
+        expectMergeError({shards[1], shards[0]}, "incomplete");
+        expectMergeError({shards[0], shards[1], shards[1], shards[2]}, "appears more than once");
+        std::vector<ShardSection> overlapping = shards;
+        overlapping[2].firstWord -= 1;
+        expectMergeError(overlapping, "overlap");
+        std::vector<ShardSection> mixed = shards;
+        mixed[1] = computeShard(dag, 1, 0, 1, 3);
+        expectMergeError(mixed, "disagree on formula 1");
+    }
+
+    // The consensus term B AND C of the 3-variable consensus function is redundant
+    {
+        auto consensus = [](size_t row) {
+            bool a = row & 1, b = row & 2, c = row & 4;
+            return (a && b) || (!a && c) || (b && c);
+        };
+        expectMinimized("the consensus function", 3, consensus, true);
+        bool exact;
+        std::string sop = Minimizer({"A", "B", "C"}, packColumn(3, consensus)).minimalSOP(exact);
+        if (sop != "(A AND B) OR (NOT A AND C)") {
+            std::cout << "FAIL: consensus function minimized to " << sop << std::endl;
+            ++failures;
+        }
+    }
+
+    // Pseudo-random functions are minimized exactly and stay equivalent
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        expectMinimized("random function " + std::to_string(seed), 6, [seed](size_t row) {
+            uint64_t x = (row + 1) * 0x9E3779B97F4A7C15ull ^ seed * 0xBF58476D1CE4E5B9ull;
+            x ^= x >> 31;
+            x *= 0x94D049BB133111EBull;
+            return ((x >> 29) & 1) != 0;
+        }, true);
+    }
+
+    // Functions wider than the exact limit use the heuristic and say so
+    expectMinimized("an 18-variable function", 18, [](size_t row) {
+        auto bit = [row](size_t j) { return ((row >> j) & 1) != 0; };
+        return (bit(0) && bit(1)) || (bit(2) && !bit(3)) || bit(4) == bit(5) ||
+               (bit(6) && bit(7) && !bit(8)) || bit(17);
+    }, false);
+
+    // Assignments: blanks, T/F, CRLF and empty lines are accepted, and rows span blocks
+    expectAssignments(" P , Q\r\n1,0\r\n\nT , f\n0,1\n", {"P", "Q"},
+                      {{true, false}, {true, false}, {false, true}}, 64);
+    {
+        std::string text = "A,B,C\n";
+        std::vector<std::vector<bool>> rows;
+        for (size_t row = 0; row < 150; ++row) {
+            rows.push_back({row % 2 == 1, row % 3 == 0, row % 7 == 0});
+            text += std::string(rows.back()[0] ? "1" : "0") + "," + (rows.back()[1] ? "1" : "0") + "," +
+                    (rows.back()[2] ? "1" : "0") + "\n";
+        }
+        expectAssignments(text, {"A", "B", "C"}, rows, 64);
+    }
+    expectAssignmentError("", "Assignment input is empty; expected a header of variable names");
+    expectAssignmentError("P,P\n1,1\n", "Duplicate variable in assignment header: P");
+    expectAssignmentError("P,Q\n1,0\n1\n", "Assignment line 3 has 1 values, expected 2");
+    expectAssignmentError("P,Q\n1,0,1\n", "Assignment line 2 has 3 values, expected 2");
+    expectAssignmentError("P,Q\n\n1 0,1\n", "Assignment line 3 has more than one value in column 1");
+    expectAssignmentError("P,Q\n1,\n", "Assignment line 2 has an empty value in column 2");
+    expectAssignmentError("P,Q\n1,x\n", "Invalid value 'x' in assignment line 2");
+
+    expectSpillResumes();
+
+    expectWriterKeepsOrder();
+
+    expectLibraryValidated();
+
+    expectSamplesReproducible();
+
+    // The checker's witness is the lowest matching row, here with 20 variables A..T so
+    // the table spans many blocks and the matches lie far from the first one
+    {
+        const std::string names = "ABCDEFGHIJKLMNOPQRST";
+        std::string all = "(A";
+        for (size_t j = 1; j < names.size(); ++j) all += std::string(" AND ") + names[j];
+        all += ")";
+        const size_t allRow = (size_t(1) << 20) - 1;
+        auto bit = [](size_t row, size_t j) { return ((row >> j) & 1) != 0; };
+
+        expectLowestRow("(T AND S AND NOT A) OR (R AND Q AND P AND O AND NOT B) OR " + all, true,
+                        [&](size_t row) {
+                            return (bit(row, 19) && bit(row, 18) && !bit(row, 0)) ||
+                                   (bit(row, 17) && bit(row, 16) && bit(row, 15) && bit(row, 14) &&
+                                    !bit(row, 1)) ||
+                                   row == allRow;
+                        });
+        expectLowestRow("NOT T OR NOT S OR A OR B OR " + all, false, [&](size_t row) {
+            return !bit(row, 19) || !bit(row, 18) || bit(row, 0) || bit(row, 1) || row == allRow;
+        });
+        expectLowestRow(all + " AND NOT A", true, [](size_t) { return false; });
+    }
+
+    if (failures) {
+        std::cout << failures << " test(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}